@@ -0,0 +1,533 @@
+// bigint.h - Radix conversion for std.math.big.int limbs
+//
+// Formatters get the magnitude of a big integer as little-endian 64-bit
+// limbs. Decimal output splits the number in halves by 10^(19 * 2^k)
+// (divide and conquer), dividing with precomputed reciprocals (Barrett) and
+// multiplying with Karatsuba, so conversion is O(M(n) log n) instead of the
+// O(n^2) of repeated division by 10^19.
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <algorithm>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace zdb {
+
+typedef std::vector<uint64_t> Limbs;
+
+static inline void NormalizeLimbs(Limbs& a) {
+    while (!a.empty() && a.back() == 0) a.pop_back();
+}
+
+static int CompareLimbs(const Limbs& a, const Limbs& b) {
+    if (a.size() != b.size()) return a.size() < b.size() ? -1 : 1;
+    for (size_t i = a.size(); i-- > 0;) {
+        if (a[i] != b[i]) return a[i] < b[i] ? -1 : 1;
+    }
+    return 0;
+}
+
+// a += b << (64 * shift)
+static void AddLimbs(Limbs& a, const uint64_t* b, size_t bn, size_t shift = 0) {
+    if (a.size() < bn + shift) a.resize(bn + shift, 0);
+    unsigned __int128 carry = 0;
+    size_t i = 0;
+    for (; i < bn; i++) {
+        carry += (unsigned __int128)a[i + shift] + b[i];
+        a[i + shift] = (uint64_t)carry;
+        carry >>= 64;
+    }
+    for (i += shift; carry && i < a.size(); i++) {
+        carry += a[i];
+        a[i] = (uint64_t)carry;
+        carry >>= 64;
+    }
+    if (carry) a.push_back((uint64_t)carry);
+}
+
+// a -= b, requires a >= b
+static void SubLimbs(Limbs& a, const uint64_t* b, size_t bn) {
+    uint64_t borrow = 0;
+    size_t i = 0;
+    for (; i < bn; i++) {
+        uint64_t bi = b[i] + borrow;
+        uint64_t next = (bi < borrow) || (a[i] < bi);
+        a[i] -= bi;
+        borrow = next;
+    }
+    for (; borrow && i < a.size(); i++) {
+        borrow = a[i] == 0;
+        a[i]--;
+    }
+    NormalizeLimbs(a);
+}
+
+static void SchoolbookMultiply(const uint64_t* a, size_t an, const uint64_t* b, size_t bn, uint64_t* out) {
+    memset(out, 0, (an + bn) * sizeof(uint64_t));
+    for (size_t i = 0; i < an; i++) {
+        unsigned __int128 carry = 0;
+        for (size_t j = 0; j < bn; j++) {
+            carry += (unsigned __int128)a[i] * b[j] + out[i + j];
+            out[i + j] = (uint64_t)carry;
+            carry >>= 64;
+        }
+        out[i + bn] = (uint64_t)carry;
+    }
+}
+
+// Montgomery arithmetic modulo a prime p = c * 2^33 + 1 below 2^62
+class NttPrime {
+public:
+    NttPrime(uint64_t p, uint64_t generator) : m_p(p) {
+        uint64_t inv = p;   // p * p == 1 (mod 8); each Newton step doubles the bits
+        for (int i = 0; i < 5; i++) inv *= 2 - p * inv;
+        m_neg_inv = 0 - inv;
+        uint64_t r = (uint64_t)(((unsigned __int128)1 << 64) % p);
+        m_r2 = (uint64_t)((unsigned __int128)r * r % p);
+        m_generator = ToMont(generator);
+    }
+
+    uint64_t Modulus() const { return m_p; }
+    uint64_t ToMont(uint64_t a) const { return Mul(a, m_r2); }
+    uint64_t FromMont(uint64_t a) const { return Reduce(a); }
+
+    uint64_t Mul(uint64_t a, uint64_t b) const {
+        return Reduce((unsigned __int128)a * b);
+    }
+
+    uint64_t Pow(uint64_t a, uint64_t e) const {
+        uint64_t result = ToMont(1);
+        for (; e; e >>= 1) {
+            if (e & 1) result = Mul(result, a);
+            a = Mul(a, a);
+        }
+        return result;
+    }
+
+    // Transforms work on plain residues kept lazily in [0, 4p) (Harvey's
+    // butterflies) and multiply by twiddles with Shoup's precomputed
+    // quotients; p < 2^62 leaves the headroom.
+    void Forward(std::vector<uint64_t>& a) const {
+        size_t n = a.size();
+        const TwiddleTable& table = Twiddles(n, false);
+        uint64_t p2 = 2 * m_p;
+        for (size_t half = n / 2; half >= 1; half /= 2) {
+            const uint64_t* tw = &table.w[half];
+            const uint64_t* tws = &table.w_shoup[half];
+            for (size_t i = 0; i < n; i += 2 * half) {
+                uint64_t* lo = &a[i];
+                uint64_t* hi = &a[i + half];
+                for (size_t j = 0; j < half; j++) {
+                    uint64_t u = lo[j], v = hi[j];
+                    uint64_t sum = u + v;
+                    lo[j] = sum >= p2 ? sum - p2 : sum;
+                    hi[j] = MulShoup(u - v + p2, tw[j], tws[j]);
+                }
+            }
+        }
+    }
+
+    // Inverse of Forward for inputs below p, scaled by 1/n; output below p
+    void Inverse(std::vector<uint64_t>& a) const {
+        size_t n = a.size();
+        const TwiddleTable& table = Twiddles(n, true);
+        uint64_t p2 = 2 * m_p;
+        for (size_t half = 1; half < n; half *= 2) {
+            const uint64_t* tw = &table.w[half];
+            const uint64_t* tws = &table.w_shoup[half];
+            for (size_t i = 0; i < n; i += 2 * half) {
+                uint64_t* lo = &a[i];
+                uint64_t* hi = &a[i + half];
+                for (size_t j = 0; j < half; j++) {
+                    uint64_t u = lo[j] >= p2 ? lo[j] - p2 : lo[j];
+                    uint64_t v = MulShoup(hi[j], tw[j], tws[j]);
+                    lo[j] = u + v;
+                    hi[j] = u - v + p2;
+                }
+            }
+        }
+        // Mul(x, s) = x * s / R, so the Montgomery form of 1/n scales plain x
+        uint64_t scale = Pow(ToMont(n), m_p - 2);
+        for (uint64_t& x : a) x = Mul(x, scale);
+    }
+
+private:
+    // Plain twiddles laid out by stage: entries [half, 2 * half) hold the
+    // powers of a primitive (2 * half)-th root (or its inverse), so every
+    // stage reads its factors contiguously.
+    struct TwiddleTable {
+        std::vector<uint64_t> w;
+        std::vector<uint64_t> w_shoup;   // floor(w * 2^64 / p)
+    };
+
+    const TwiddleTable& Twiddles(size_t size, bool inverse) const {
+        std::lock_guard<std::mutex> lock(m_twiddle_mutex);
+        TwiddleTable& table = m_twiddles[std::make_pair(size, inverse)];
+        if (!table.w.empty()) return table;
+        size_t top = size / 2;
+        table.w.assign(std::max<size_t>(size, 2), 0);
+        uint64_t step = (m_p - 1) / size;
+        uint64_t root = Pow(m_generator, inverse ? m_p - 1 - step : step);
+        table.w[top] = 1;
+        for (size_t j = 1; j < top; j++) table.w[top + j] = Mul(table.w[top + j - 1], root);   // plain * Montgomery = plain
+        for (size_t half = top / 2; half >= 1; half /= 2) {
+            for (size_t j = 0; j < half; j++) table.w[half + j] = table.w[2 * half + 2 * j];
+        }
+        table.w_shoup.resize(table.w.size());
+        for (size_t i = 0; i < table.w.size(); i++) {
+            table.w_shoup[i] = (uint64_t)(((unsigned __int128)table.w[i] << 64) / m_p);
+        }
+        return table;
+    }
+
+    // x * w mod p in [0, 2p) for any 64-bit x
+    uint64_t MulShoup(uint64_t x, uint64_t w, uint64_t w_shoup) const {
+        uint64_t q = (uint64_t)(((unsigned __int128)x * w_shoup) >> 64);
+        return x * w - q * m_p;
+    }
+
+    uint64_t Reduce(unsigned __int128 t) const {
+        uint64_t m = (uint64_t)t * m_neg_inv;
+        uint64_t r = (uint64_t)((t + (unsigned __int128)m * m_p) >> 64);
+        return r >= m_p ? r - m_p : r;
+    }
+
+    uint64_t m_p;
+    uint64_t m_neg_inv;
+    uint64_t m_r2;
+    uint64_t m_generator;
+    mutable std::mutex m_twiddle_mutex;
+    mutable std::map<std::pair<size_t, bool>, TwiddleTable> m_twiddles;
+};
+
+// Operand transformed under both primes, split into 32-bit digits. A
+// spectrum can be reused across products of the same transform size.
+struct NttSpectrum {
+    size_t size = 0;
+    std::vector<uint64_t> residues[2];
+};
+
+static const NttPrime* NttPrimes() {
+    static const NttPrime primes[2] = {
+        NttPrime(0x3fffffee00000001ull, 3),
+        NttPrime(0x3fffffb400000001ull, 19),
+    };
+    return primes;
+}
+
+// Transform size that holds an an-by-bn limb product without wrapping
+static size_t NttSize(size_t an, size_t bn) {
+    size_t n = 1;
+    while (n < 2 * (an + bn)) n <<= 1;
+    return n;
+}
+
+static NttSpectrum NttForward(const uint64_t* a, size_t an, size_t size) {
+    NttSpectrum spectrum;
+    spectrum.size = size;
+    for (int k = 0; k < 2; k++) {
+        const NttPrime& prime = NttPrimes()[k];
+        std::vector<uint64_t>& f = spectrum.residues[k];
+        f.assign(size, 0);
+        for (size_t i = 0; i < an; i++) {
+            f[2 * i] = a[i] & 0xffffffffu;
+            f[2 * i + 1] = a[i] >> 32;
+        }
+        prime.Forward(f);
+    }
+    return spectrum;
+}
+
+// Pointwise product, inverse transform, and CRT recombination. Each
+// coefficient is below size * 2^64, far under the ~2^124 product of the primes:
+// x = r0 + p0 * ((r1 - r0) * p0^-1 mod p1).
+static Limbs NttProduct(const NttSpectrum& a, const NttSpectrum& b, size_t out_limbs) {
+    std::vector<uint64_t> residues[2];
+    for (int k = 0; k < 2; k++) {
+        const NttPrime& prime = NttPrimes()[k];
+        std::vector<uint64_t>& f = residues[k];
+        f.resize(a.size);
+        // Both factors are below 2p, inside Montgomery's p * 2^64 bound; the
+        // stray 1/R is undone during recombination
+        for (size_t i = 0; i < a.size; i++) f[i] = prime.Mul(a.residues[k][i], b.residues[k][i]);
+        prime.Inverse(f);
+    }
+    const NttPrime& p0 = NttPrimes()[0];
+    const NttPrime& p1 = NttPrimes()[1];
+    uint64_t m0 = p0.Modulus(), m1 = p1.Modulus();
+    uint64_t inv = p1.Pow(p1.ToMont(m0 % m1), m1 - 2);
+    Limbs out(out_limbs, 0);
+    unsigned __int128 carry = 0;
+    for (size_t i = 0; i < 2 * out_limbs && i < a.size; i++) {
+        uint64_t r0 = p0.ToMont(residues[0][i]);
+        uint64_t r1 = p1.ToMont(residues[1][i]);
+        uint64_t r0m = r0 % m1;
+        uint64_t t = p1.Mul(r1 >= r0m ? r1 - r0m : r1 + m1 - r0m, inv);   // plain * Montgomery = plain
+        carry += (unsigned __int128)m0 * t + r0;
+        out[i / 2] |= (uint64_t)(uint32_t)carry << (32 * (i & 1));
+        carry >>= 32;
+    }
+    return out;
+}
+
+static Limbs NttMultiply(const uint64_t* a, size_t an, const uint64_t* b, size_t bn) {
+    size_t size = NttSize(an, bn);
+    NttSpectrum fa = NttForward(a, an, size);
+    if (a == b && an == bn) return NttProduct(fa, fa, an + bn);
+    return NttProduct(fa, NttForward(b, bn, size), an + bn);
+}
+
+static constexpr size_t kKaratsubaThreshold = 32;
+static constexpr size_t kNttThreshold = 1024;
+
+static Limbs MultiplyLimbs(const uint64_t* a, size_t an, const uint64_t* b, size_t bn);
+
+// Both operands have n limbs
+static Limbs KaratsubaMultiply(const uint64_t* a, const uint64_t* b, size_t n) {
+    size_t m = n / 2;
+    Limbs z0 = MultiplyLimbs(a, m, b, m);
+    Limbs z2 = MultiplyLimbs(a + m, n - m, b + m, n - m);
+    Limbs sa(a, a + m), sb(b, b + m);
+    AddLimbs(sa, a + m, n - m);
+    AddLimbs(sb, b + m, n - m);
+    Limbs z1 = MultiplyLimbs(sa.data(), sa.size(), sb.data(), sb.size());
+    NormalizeLimbs(z1);
+    NormalizeLimbs(z0);
+    NormalizeLimbs(z2);
+    SubLimbs(z1, z0.data(), z0.size());
+    SubLimbs(z1, z2.data(), z2.size());
+
+    Limbs out(2 * n, 0);
+    AddLimbs(out, z0.data(), z0.size());
+    AddLimbs(out, z1.data(), z1.size(), m);
+    AddLimbs(out, z2.data(), z2.size(), 2 * m);
+    out.resize(2 * n);
+    return out;
+}
+
+static Limbs MultiplyLimbs(const uint64_t* a, size_t an, const uint64_t* b, size_t bn) {
+    if (an < bn) {
+        std::swap(a, b);
+        std::swap(an, bn);
+    }
+    Limbs out;
+    if (bn == 0) return out;
+    if (bn < kKaratsubaThreshold) {
+        out.resize(an + bn);
+        SchoolbookMultiply(a, an, b, bn, out.data());
+        return out;
+    }
+    if (bn >= kNttThreshold) return NttMultiply(a, an, b, bn);
+    if (an == bn) return KaratsubaMultiply(a, b, an);
+    // Unbalanced: multiply bn-limb slices of a and accumulate
+    out.assign(an + bn, 0);
+    for (size_t i = 0; i < an; i += bn) {
+        size_t len = std::min(bn, an - i);
+        Limbs part = len == bn ? KaratsubaMultiply(a + i, b, bn) : MultiplyLimbs(a + i, len, b, bn);
+        AddLimbs(out, part.data(), part.size(), i);
+    }
+    out.resize(an + bn);
+    return out;
+}
+
+static Limbs MultiplyLimbs(const Limbs& a, const Limbs& b) {
+    Limbs out = MultiplyLimbs(a.data(), a.size(), b.data(), b.size());
+    NormalizeLimbs(out);
+    return out;
+}
+
+// a /= d in place; returns the remainder
+static uint64_t DivideLimbsSmall(Limbs& a, uint64_t d) {
+    unsigned __int128 rem = 0;
+    for (size_t i = a.size(); i-- > 0;) {
+        rem = (rem << 64) | a[i];
+        a[i] = (uint64_t)(rem / d);
+        rem %= d;
+    }
+    NormalizeLimbs(a);
+    return (uint64_t)rem;
+}
+
+static Limbs ShiftRightLimbs(const Limbs& a, size_t limbs) {
+    if (a.size() <= limbs) return Limbs();
+    return Limbs(a.begin() + limbs, a.end());
+}
+
+class DecimalConverter {
+public:
+    static constexpr uint64_t kChunk = 10000000000000000000ull;   // 10^19
+    static constexpr size_t kChunkDigits = 19;
+    static constexpr size_t kBaseCaseLimbs = 24;
+
+    // Decimal digits of the magnitude (no sign)
+    std::string ToDecimal(Limbs x) {
+        NormalizeLimbs(x);
+        if (x.empty()) return "0";
+        std::string out;
+        out.reserve(x.size() * 20);
+        std::lock_guard<std::mutex> lock(m_mutex);
+        // Smallest level whose square exceeds x
+        int level = 0;
+        while (2 * GetLevel(level).power.size() <= x.size() + 1) level++;
+        Convert(x, level, 0, out);
+        return out;
+    }
+
+private:
+    // P_k = 10^(19 * 2^k) and R_k = floor(B^(2n) / P_k), n = limbs of P_k,
+    // B = 2^64. Above the NTT threshold both are kept transformed at the sizes
+    // DivideByPower multiplies them at.
+    struct Level {
+        Limbs power;
+        Limbs reciprocal;
+        NttSpectrum power_spectrum;
+        NttSpectrum reciprocal_spectrum;
+    };
+
+    const Level& GetLevel(size_t k) {
+        while (m_levels.size() <= k) {
+            size_t i = m_levels.size();
+            Level level;
+            if (i == 0) {
+                level.power = Limbs{kChunk};
+                level.reciprocal.assign(3, 0);
+                level.reciprocal[2] = 1;
+                DivideLimbsSmall(level.reciprocal, kChunk);
+            } else {
+                // R_{k-1}^2 approximates B^(4n')/P_k from below; rescale to B^(2n)
+                const Level& prev = m_levels[i - 1];
+                level.power = MultiplyLimbs(prev.power, prev.power);
+                level.reciprocal = ShiftRightLimbs(MultiplyLimbs(prev.reciprocal, prev.reciprocal),
+                                                   4 * prev.power.size() - 2 * level.power.size());
+            }
+            const Limbs& d = level.power;
+            RefineReciprocal(d, 2 * d.size(), level.reciprocal);
+            if (d.size() >= kNttThreshold) {
+                const Limbs& r = level.reciprocal;
+                level.reciprocal_spectrum = NttForward(r.data(), r.size(), NttSize(2 * d.size(), r.size()));
+                level.power_spectrum = NttForward(d.data(), d.size(), NttSize(d.size(), d.size()));
+            }
+            m_levels.push_back(std::move(level));
+        }
+        return m_levels[k];
+    }
+
+    // Newton iteration from below, then exact correction: r = floor(B^m / d)
+    static void RefineReciprocal(const Limbs& d, size_t m, Limbs& r) {
+        Limbs bm(m + 1, 0);
+        bm[m] = 1;
+        while (true) {
+            Limbs dr = MultiplyLimbs(d, r);
+            while (CompareLimbs(dr, bm) > 0) {
+                SubLimbs(dr, d.data(), d.size());
+                Limbs one{1};
+                SubLimbs(r, one.data(), 1);
+            }
+            Limbs e = bm;
+            SubLimbs(e, dr.data(), dr.size());
+            if (CompareLimbs(e, d) < 0) return;
+            Limbs step = ShiftRightLimbs(MultiplyLimbs(r, e), m);
+            if (step.empty()) {
+                // Within a few units: step by one
+                while (CompareLimbs(e, d) >= 0) {
+                    SubLimbs(e, d.data(), d.size());
+                    Limbs one{1};
+                    AddLimbs(r, one.data(), 1);
+                }
+                return;
+            }
+            AddLimbs(r, step.data(), step.size());
+        }
+    }
+
+    // q = x / P_k, x = remainder; requires x < P_k^2
+    void DivideByPower(Limbs& x, size_t k, Limbs& q) {
+        const Level& level = GetLevel(k);
+        const Limbs& d = level.power;
+        const Limbs& r = level.reciprocal;
+        Limbs qd;
+        if (!level.power_spectrum.size) {
+            q = ShiftRightLimbs(MultiplyLimbs(x, r), 2 * d.size());
+            qd = MultiplyLimbs(q, d);
+        } else {
+            NttSpectrum fx = NttForward(x.data(), x.size(), level.reciprocal_spectrum.size);
+            q = ShiftRightLimbs(NttProduct(fx, level.reciprocal_spectrum, 2 * d.size() + r.size()), 2 * d.size());
+            NormalizeLimbs(q);
+            NttSpectrum fq = NttForward(q.data(), q.size(), level.power_spectrum.size);
+            qd = NttProduct(fq, level.power_spectrum, q.size() + d.size());
+            NormalizeLimbs(qd);
+        }
+        SubLimbs(x, qd.data(), qd.size());
+        while (CompareLimbs(x, d) >= 0) {
+            SubLimbs(x, d.data(), d.size());
+            Limbs one{1};
+            AddLimbs(q, one.data(), 1);
+        }
+    }
+
+    // Append x < P_{level+1} padded to `width` digits (0 = no padding)
+    void Convert(Limbs& x, int level, size_t width, std::string& out) {
+        if (level < 0 || x.size() <= kBaseCaseLimbs) {
+            BaseCase(x, width, out);
+            return;
+        }
+        size_t low_digits = kChunkDigits << level;
+        Limbs q;
+        DivideByPower(x, (size_t)level, q);
+        if (q.empty() && width == 0) {
+            Convert(x, level - 1, 0, out);
+            return;
+        }
+        Convert(q, level - 1, width > low_digits ? width - low_digits : 0, out);
+        Convert(x, level - 1, low_digits, out);
+    }
+
+    // Repeated division by 10^19; quadratic, but only on small inputs
+    static void BaseCase(Limbs& x, size_t width, std::string& out) {
+        std::vector<uint64_t> chunks;
+        while (!x.empty()) chunks.push_back(DivideLimbsSmall(x, kChunk));
+        std::string digits;
+        char buf[24];
+        for (size_t i = chunks.size(); i-- > 0;) {
+            snprintf(buf, sizeof(buf), i + 1 == chunks.size() ? "%llu" : "%019llu", (unsigned long long)chunks[i]);
+            digits += buf;
+        }
+        if (digits.size() < width) out.append(width - digits.size(), '0');
+        out += digits;
+    }
+
+    std::mutex m_mutex;
+    std::vector<Level> m_levels;
+};
+
+// Lowercase hex digits of the magnitude (no prefix)
+static std::string LimbsToHex(const Limbs& x) {
+    size_t n = x.size();
+    while (n > 0 && x[n - 1] == 0) n--;
+    if (n == 0) return "0";
+    std::string out;
+    out.reserve(n * 16);
+    char buf[24];
+    snprintf(buf, sizeof(buf), "%llx", (unsigned long long)x[n - 1]);
+    out += buf;
+    for (size_t i = n - 1; i-- > 0;) {
+        snprintf(buf, sizeof(buf), "%016llx", (unsigned long long)x[i]);
+        out += buf;
+    }
+    return out;
+}
+
+static uint64_t LimbsBitLength(const Limbs& x) {
+    size_t n = x.size();
+    while (n > 0 && x[n - 1] == 0) n--;
+    if (n == 0) return 0;
+    return (uint64_t)(n - 1) * 64 + (64 - __builtin_clzll(x[n - 1]));
+}
+
+} // namespace zdb
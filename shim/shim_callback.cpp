@@ -7,15 +7,23 @@
 
 #include "lldb/API/LLDB.h"
 #include "offset_loader.h"
+#include "bigint.h"
+#include "simd_scan.h"
+#include "wyhash.h"
 #include <dlfcn.h>
 #include <unistd.h>
 #include <cstdio>
 #include <cstring>
 #include <cstdlib>
+#include <cmath>
 #include <vector>
 #include <string>
 #include <regex>
 #include <functional>
+#include <algorithm>
+#include <map>
+#include <mutex>
+#include <unordered_map>
 
 using namespace lldb;
 
@@ -30,785 +38,6404 @@ namespace lldb {
 static std::vector<SBTypeSummary> g_formatters;
 
 //===----------------------------------------------------------------------===//
-// Formatter Callbacks
+// Type Layout Cache
 //===----------------------------------------------------------------------===//
 
-static bool ZigSliceSummary(SBValue value, SBTypeSummaryOptions options, SBStream &stream) {
-    SBValue len = value.GetChildMemberWithName("len");
-    SBValue ptr = value.GetChildMemberWithName("ptr");
-    if (len.IsValid() && ptr.IsValid()) {
-        stream.Printf("len=%llu ptr=0x%llx",
-            (unsigned long long)len.GetValueAsUnsigned(0),
-            (unsigned long long)ptr.GetValueAsUnsigned(0));
-        return true;
+// Per-type layout facts (field offsets, encodings) are derived from SBType
+// once and reused for every value of that type. Entries are never erased, so
+// returned references stay valid; instead the key names the defining module
+// (UUID, path and symbol count), so a rebuilt binary or a second target gets
+// fresh layouts rather than stale offsets. Types without a name are keyed by
+// their fields.
+static std::string TypeKey(SBType type) {
+    std::string key;
+    SBModule module = type.GetModule();
+    if (module.IsValid()) {
+        const char* uuid = module.GetUUIDString();
+        const char* dir = module.GetFileSpec().GetDirectory();
+        const char* file = module.GetFileSpec().GetFilename();
+        key = std::string(uuid ? uuid : "") + ":" + (dir ? dir : "") + "/" + (file ? file : "") + "#" +
+              std::to_string(module.GetNumSymbols()) + ":";
     }
-    return false;
+    key += std::to_string(type.GetByteSize()) + ":";
+    const char* name = type.GetName();
+    if (name && name[0]) return key + name;
+
+    SBType canonical = type.GetCanonicalType();
+    key += "{";
+    for (uint32_t i = 0; i < canonical.GetNumberOfFields(); i++) {
+        SBTypeMember field = canonical.GetFieldAtIndex(i);
+        const char* field_name = field.GetName();
+        const char* field_type = field.GetType().GetName();
+        key += std::string(field_name ? field_name : "") + "@" + std::to_string(field.GetOffsetInBits()) + ":" +
+               (field_type ? field_type : "") + ";";
+    }
+    return key + "}";
 }
 
-static bool ZigStringSummary(SBValue value, SBTypeSummaryOptions options, SBStream &stream) {
-    SBValue len = value.GetChildMemberWithName("len");
-    SBValue ptr = value.GetChildMemberWithName("ptr");
-    if (!len.IsValid() || !ptr.IsValid()) return false;
+static std::string TypeKey(SBValue value) {
+    return TypeKey(value.GetType());
+}
 
-    uint64_t len_val = len.GetValueAsUnsigned(0);
-    uint64_t ptr_val = ptr.GetValueAsUnsigned(0);
+// A type plus the target its related types are looked up in
+struct TargetType {
+    SBTarget target;
+    SBType type;
+};
 
-    // Use stack buffer to avoid heap allocation on every render
-    static constexpr size_t kMaxStringLen = 1024;
-    if (len_val > 0 && len_val <= kMaxStringLen && ptr_val != 0) {
-        SBProcess process = value.GetProcess();
-        if (process.IsValid()) {
-            char buffer[kMaxStringLen + 1];
-            SBError error;
-            size_t to_read = len_val < kMaxStringLen ? len_val : kMaxStringLen;
-            size_t bytes_read = process.ReadMemory(ptr_val, buffer, to_read, error);
-            if (bytes_read > 0 && error.Success()) {
-                buffer[bytes_read] = '\0';
-                stream.Printf("\"%s\"", buffer);
-                if (len_val > kMaxStringLen) {
-                    stream.Printf("... (%llu bytes)", (unsigned long long)len_val);
-                }
-                return true;
-            }
+static std::string TypeKey(const TargetType& source) {
+    return TypeKey(source.type);
+}
+
+// Classifiers take an SBType, or an SBValue / TargetType when they need
+// target lookups
+template <typename Layout>
+class TypeLayoutCache {
+public:
+    template <typename Source>
+    const Layout& Get(Source source, Layout (*classify)(Source)) {
+        std::string key = TypeKey(source);
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            auto it = m_layouts.find(key);
+            if (it != m_layouts.end()) return it->second;
         }
+        Layout layout = classify(source);
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_layouts.emplace(key, std::move(layout)).first->second;
     }
-    stream.Printf("len=%llu ptr=0x%llx", (unsigned long long)len_val, (unsigned long long)ptr_val);
-    return true;
+
+private:
+    std::mutex m_mutex;
+    std::unordered_map<std::string, Layout> m_layouts;
+};
+
+// Little-endian load of up to 8 bytes
+static uint64_t LoadUnsigned(const uint8_t* bytes, size_t size) {
+    uint64_t result = 0;
+    for (size_t i = 0; i < size && i < 8; i++) {
+        result |= (uint64_t)bytes[i] << (8 * i);
+    }
+    return result;
 }
 
-static bool ZigOptionalSummary(SBValue value, SBTypeSummaryOptions options, SBStream &stream) {
-    // Zig optionals have 'some' (discriminant) and 'data' (payload) fields
-    // some == 1 means has value, some == 0 means null
-    SBValue some = value.GetChildMemberWithName("some");
-    if (some.IsValid()) {
-        if (some.GetValueAsUnsigned(0) == 0) {
-            stream.Printf("null");
-            return true;
+// Read bytes from the value's already-fetched data (no extra memory read)
+static bool ReadValueBytes(SBValue value, uint64_t offset, void* out, size_t size) {
+    SBData data = value.GetData();
+    if (!data.IsValid() || offset + size > data.GetByteSize()) return false;
+    SBError error;
+    return data.ReadRawData(error, offset, out, size) == size && error.Success();
+}
+
+//===----------------------------------------------------------------------===//
+// Target Memory
+//===----------------------------------------------------------------------===//
+
+// Large arrays are fetched in a few big reads rather than element by element
+static constexpr size_t kBulkReadChunk = 8 * 1024 * 1024;
+
+static bool ReadTargetMemory(SBProcess process, uint64_t addr, size_t size, std::vector<uint8_t>& out) {
+    out.resize(size);
+    size_t done = 0;
+    while (done < size) {
+        size_t chunk = std::min(size - done, kBulkReadChunk);
+        SBError error;
+        size_t got = process.ReadMemory(addr + done, out.data() + done, chunk, error);
+        if (got != chunk || error.Fail()) {
+            out.resize(done + got);
+            return false;
         }
-        // Has value - show the data field
-        SBValue data = value.GetChildMemberWithName("data");
-        if (data.IsValid()) {
-            const char* summary = data.GetSummary();
-            if (summary && summary[0]) {
-                stream.Printf("%s", summary);
-                return true;
-            }
-            const char* val = data.GetValue();
-            if (val && val[0]) {
-                stream.Printf("%s", val);
-                return true;
+        done += chunk;
+    }
+    return true;
+}
+
+// Page-granular cache for pointer-chasing walks (list nodes, tree nodes):
+// nodes allocated near each other share one read, and a walk that revisits
+// nodes (cycle checks, re-rendering) costs no extra reads. Contents are
+// dropped whenever the process resumes.
+class TargetReadCache {
+public:
+    static constexpr uint64_t kPageSize = 4096;
+    static constexpr size_t kMaxPages = 1024;
+
+    bool Read(SBProcess process, uint64_t addr, void* out, size_t size) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        Sync(process);
+        uint8_t* dst = static_cast<uint8_t*>(out);
+        while (size > 0) {
+            uint64_t page = addr & ~(kPageSize - 1);
+            size_t offset = addr - page;
+            size_t n = std::min(size, (size_t)(kPageSize - offset));
+            const std::vector<uint8_t>* bytes = Page(process, page);
+            if (bytes) {
+                memcpy(dst, bytes->data() + offset, n);
+            } else {
+                // Page straddles unmapped memory; read just this range
+                SBError error;
+                if (process.ReadMemory(addr, dst, n, error) != n || error.Fail()) return false;
             }
+            addr += n;
+            dst += n;
+            size -= n;
         }
-        stream.Printf("(has value)");
         return true;
     }
 
-    // Check for optional pointer types (?*T, ?[*]T) which LLDB shows as plain pointers
-    // Don't try to dereference - just show pointer value or null
-    const char* type_name = value.GetTypeName();
-    if (type_name && type_name[0] == '?' &&
-        (type_name[1] == '*' || (type_name[1] == '[' && type_name[2] == '*'))) {
-        uint64_t ptr_val = value.GetValueAsUnsigned(0);
-        if (ptr_val == 0) {
-            stream.Printf("null");
-        } else {
-            stream.Printf("0x%llx", (unsigned long long)ptr_val);
-        }
+    bool ReadPointer(SBProcess process, uint64_t addr, uint64_t word_size, uint64_t& out) {
+        uint8_t word[8];
+        if (word_size > sizeof(word) || !Read(process, addr, word, word_size)) return false;
+        out = LoadUnsigned(word, word_size);
         return true;
     }
 
-    // Fallback for other optional layouts - be conservative, don't dereference
-    stream.Printf("?");
-    return true;
+private:
+    void Sync(SBProcess process) {
+        uint32_t process_id = process.GetUniqueID();
+        uint32_t stop_id = process.GetStopID();
+        if (process_id != m_process_id || stop_id != m_stop_id) {
+            m_pages.clear();
+            m_process_id = process_id;
+            m_stop_id = stop_id;
+        }
+    }
+
+    const std::vector<uint8_t>* Page(SBProcess process, uint64_t page) {
+        auto it = m_pages.find(page);
+        if (it != m_pages.end()) return &it->second;
+        std::vector<uint8_t> bytes(kPageSize);
+        SBError error;
+        if (process.ReadMemory(page, bytes.data(), kPageSize, error) != kPageSize || error.Fail()) {
+            return nullptr;
+        }
+        if (m_pages.size() >= kMaxPages) m_pages.clear();
+        return &m_pages.emplace(page, std::move(bytes)).first->second;
+    }
+
+    std::mutex m_mutex;
+    uint32_t m_process_id = 0;
+    uint32_t m_stop_id = 0;
+    std::unordered_map<uint64_t, std::vector<uint8_t>> m_pages;
+};
+
+static TargetReadCache g_read_cache;
+
+// Wrap bytes read in bulk as a typed value so the registered summaries apply
+static SBValue MakeValueFromBytes(SBTarget target, const char* name, const uint8_t* bytes,
+                                  size_t size, SBType type) {
+    SBData data;
+    SBError error;
+    data.SetData(error, bytes, size, target.GetByteOrder(), (uint8_t)target.GetAddressByteSize());
+    if (error.Fail()) return SBValue();
+    return target.CreateValueFromData(name, data, type);
 }
 
-static bool ZigErrorUnionSummary(SBValue value, SBTypeSummaryOptions options, SBStream &stream) {
-    // Zig error unions have 'tag' (error code, 0 = success) and 'value' (payload) fields
-    SBValue tag = value.GetChildMemberWithName("tag");
-    if (!tag.IsValid()) {
-        // Fallback: try older field names
-        tag = value.GetChildMemberWithName("error");
-        if (!tag.IsValid()) tag = value.GetChildMemberWithName("err");
+// One-line rendering of a value: its summary, else its plain value
+static std::string ValueText(SBValue value) {
+    const char* summary = value.GetSummary();
+    if (summary && summary[0]) return summary;
+    const char* val = value.GetValue();
+    if (val && val[0]) return val;
+    return "{...}";
+}
+
+//===----------------------------------------------------------------------===//
+// Symbol Index
+//===----------------------------------------------------------------------===//
+
+// Address -> symbol for vtables, function pointers and return addresses.
+// Each module's code and data symbols are sorted by load address once, on
+// first use, so a lookup is two binary searches (section, then symbol)
+// instead of an SB symbol-context resolution. Once per stop the module list
+// is compared against a signature (UUID, file and load address of every
+// loaded module), so a dlclose + dlopen that keeps the module count still
+// rebuilds the section ranges; a module's table is kept as long as the
+// module stays loaded at the same address.
+class SymbolIndex {
+public:
+    struct Hit {
+        std::string name;
+        uint64_t start = 0;
+    };
+
+    bool Lookup(SBTarget target, uint64_t addr, Hit& hit) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        Sync(target);
+        auto section = std::upper_bound(m_sections.begin(), m_sections.end(), addr,
+            [](uint64_t a, const SectionRange& s) { return a < s.start; });
+        if (section == m_sections.begin() || addr >= (--section)->end) return false;
+        ModuleSymbols& module = m_modules[section->module_key];
+        if (!module.built) Build(target, section->module_index, module);
+        auto symbol = std::upper_bound(module.symbols.begin(), module.symbols.end(), addr,
+            [](uint64_t a, const SymbolRange& s) { return a < s.start; });
+        if (symbol == module.symbols.begin() || addr >= (--symbol)->end) return false;
+        hit.name = symbol->name;
+        hit.start = symbol->start;
+        return true;
     }
-    if (!tag.IsValid()) return false;
 
-    uint64_t tag_val = tag.GetValueAsUnsigned(0);
-    if (tag_val != 0) {
-        // Error case - show error name if available
-        const char* error_name = tag.GetValue();
-        if (error_name) {
-            stream.Printf("error.%s", error_name);
-        } else {
-            stream.Printf("error(%llu)", (unsigned long long)tag_val);
+private:
+    // Names point into LLDB's string pool, which lives as long as the
+    // debugger; a table of many thousands of symbols stores no strings
+    struct SymbolRange {
+        uint64_t start;
+        uint64_t end;
+        const char* name;
+    };
+
+    struct ModuleSymbols {
+        bool built = false;
+        std::vector<SymbolRange> symbols;
+    };
+
+    struct SectionRange {
+        uint64_t start;
+        uint64_t end;
+        uint32_t module_index;
+        std::string module_key;
+    };
+
+    // "uuid:file@load;" per module, load being its first loaded section
+    static std::string ModuleListSignature(SBTarget target) {
+        std::string signature;
+        uint32_t num_modules = target.GetNumModules();
+        for (uint32_t i = 0; i < num_modules; i++) {
+            SBModule module = target.GetModuleAtIndex(i);
+            uint64_t load = LLDB_INVALID_ADDRESS;
+            for (size_t s = 0; s < module.GetNumSections() && load == LLDB_INVALID_ADDRESS; s++) {
+                load = module.GetSectionAtIndex(s).GetLoadAddress(target);
+            }
+            const char* uuid = module.GetUUIDString();
+            const char* file = module.GetFileSpec().GetFilename();
+            signature += std::string(uuid ? uuid : "") + ":" + (file ? file : "") + "@" + std::to_string(load) + ";";
         }
-        return true;
+        return signature;
     }
 
-    // Success case - show payload
-    SBValue payload = value.GetChildMemberWithName("value");
-    if (payload.IsValid()) {
-        const char* summary = payload.GetSummary();
-        if (summary && summary[0]) {
-            stream.Printf("%s", summary);
-            return true;
+    void Sync(SBTarget target) {
+        SBProcess process = target.GetProcess();
+        uint32_t process_id = process.GetUniqueID();
+        uint32_t stop_id = process.GetStopID();
+        if (process_id == m_process_id && stop_id == m_stop_id) return;
+        m_process_id = process_id;
+        m_stop_id = stop_id;
+        std::string signature = ModuleListSignature(target);
+        if (signature == m_signature) return;
+        m_signature.swap(signature);
+        m_sections.clear();
+        uint32_t num_modules = target.GetNumModules();
+        std::unordered_map<std::string, ModuleSymbols> kept;
+        for (uint32_t i = 0; i < num_modules; i++) {
+            SBModule module = target.GetModuleAtIndex(i);
+            std::vector<SectionRange> ranges;
+            int64_t slide = 0;
+            for (size_t s = 0; s < module.GetNumSections(); s++) {
+                SBSection section = module.GetSectionAtIndex(s);
+                uint64_t load = section.GetLoadAddress(target);
+                uint64_t size = section.GetByteSize();
+                // Unloaded sections and Mach-O's __PAGEZERO (no file bytes)
+                if (load == LLDB_INVALID_ADDRESS || size == 0 || section.GetFileByteSize() == 0) continue;
+                slide = (int64_t)(load - section.GetFileAddress());
+                ranges.push_back(SectionRange{load, load + size, i, ""});
+            }
+            if (ranges.empty()) continue;
+            const char* uuid = module.GetUUIDString();
+            const char* file = module.GetFileSpec().GetFilename();
+            std::string key = std::string(uuid ? uuid : "") + ":" + (file ? file : "") + "@" + std::to_string(slide);
+            auto it = m_modules.find(key);
+            if (it != m_modules.end()) kept[key] = std::move(it->second);
+            for (SectionRange& range : ranges) {
+                range.module_key = key;
+                m_sections.push_back(std::move(range));
+            }
         }
-        const char* val = payload.GetValue();
-        if (val && val[0]) {
-            stream.Printf("%s", val);
-            return true;
+        m_modules.swap(kept);
+        std::sort(m_sections.begin(), m_sections.end(),
+            [](const SectionRange& a, const SectionRange& b) { return a.start < b.start; });
+    }
+
+    static void Build(SBTarget target, uint32_t module_index, ModuleSymbols& table) {
+        table.built = true;
+        SBModule module = target.GetModuleAtIndex(module_index);
+        size_t count = module.GetNumSymbols();
+        table.symbols.reserve(count);
+        for (size_t i = 0; i < count; i++) {
+            SBSymbol symbol = module.GetSymbolAtIndex(i);
+            SymbolType type = symbol.GetType();
+            if (type != eSymbolTypeCode && type != eSymbolTypeData) continue;
+            const char* name = symbol.GetName();
+            uint64_t start = symbol.GetStartAddress().GetLoadAddress(target);
+            if (!name || start == LLDB_INVALID_ADDRESS) continue;
+            SBAddress end_address = symbol.GetEndAddress();
+            uint64_t end = end_address.IsValid() ? end_address.GetLoadAddress(target) : LLDB_INVALID_ADDRESS;
+            table.symbols.push_back(SymbolRange{start, end == LLDB_INVALID_ADDRESS ? start : end, name});
+        }
+        std::sort(table.symbols.begin(), table.symbols.end(),
+            [](const SymbolRange& a, const SymbolRange& b) { return a.start < b.start; });
+        // Sizeless symbols run to the next symbol
+        for (size_t i = 0; i < table.symbols.size(); i++) {
+            SymbolRange& symbol = table.symbols[i];
+            if (symbol.end > symbol.start) continue;
+            symbol.end = i + 1 < table.symbols.size() ? table.symbols[i + 1].start : symbol.start + 1;
         }
     }
-    stream.Printf("(success)");
-    return true;
+
+    std::mutex m_mutex;
+    uint32_t m_process_id = 0;
+    uint32_t m_stop_id = UINT32_MAX;
+    std::string m_signature;
+    std::vector<SectionRange> m_sections;
+    std::unordered_map<std::string, ModuleSymbols> m_modules;
+};
+
+static SymbolIndex g_symbol_index;
+
+// "name" or "name+0x10"; "" when no symbol covers addr
+static std::string SymbolTextAt(SBTarget target, uint64_t addr) {
+    SymbolIndex::Hit hit;
+    if (!g_symbol_index.Lookup(target, addr, hit)) return "";
+    if (addr == hit.start) return hit.name;
+    char offset[32];
+    snprintf(offset, sizeof(offset), "+0x%llx", (unsigned long long)(addr - hit.start));
+    return hit.name + offset;
 }
 
-static bool ZigTaggedUnionSummary(SBValue value, SBTypeSummaryOptions options, SBStream &stream) {
-    SBValue tag = value.GetChildMemberWithName("tag");
-    if (!tag.IsValid()) return false;
+//===----------------------------------------------------------------------===//
+// Optional Layout Classification
+//===----------------------------------------------------------------------===//
 
-    const char* tag_val = tag.GetValue();
-    if (!tag_val) return false;
+// How an optional type represents null
+enum class OptionalEncoding {
+    Unknown,
+    Flag,           // { data: T, some: u8 } - explicit discriminant
+    NullPointer,    // ?*T, ?[*]T - the zero address is null
+    NullSlicePtr,   // ?[]T - a slice whose ptr is zero is null
+    ErrorSetZero,   // ?E for an error set E - error value 0 is null
+};
 
-    stream.Printf(".%s", tag_val);
+struct OptionalLayout {
+    OptionalEncoding encoding = OptionalEncoding::Unknown;
+    uint64_t word_offset = 0;           // offset of the word that decides null-ness
+    uint32_t word_size = 0;
+};
 
-    // Try to show active payload
-    SBValue payload = value.GetChildMemberWithName("payload");
-    if (payload.IsValid()) {
-        SBValue active = payload.GetChildMemberWithName(tag_val);
-        if (active.IsValid()) {
-            const char* summary = active.GetSummary();
-            if (summary && summary[0]) {
-                stream.Printf(" = %s", summary);
-            }
-        }
+static OptionalLayout ClassifyOptional(SBType type) {
+    OptionalLayout layout;
+    SBType canonical = type.GetCanonicalType();
+
+    SBTypeMember some, ptr;
+    bool has_data = false, has_len = false;
+    for (uint32_t i = 0; i < canonical.GetNumberOfFields(); i++) {
+        SBTypeMember field = canonical.GetFieldAtIndex(i);
+        const char* name = field.GetName();
+        if (!name) continue;
+        if (strcmp(name, "some") == 0) some = field;
+        else if (strcmp(name, "data") == 0) has_data = true;
+        else if (strcmp(name, "ptr") == 0) ptr = field;
+        else if (strcmp(name, "len") == 0) has_len = true;
     }
-    return true;
+
+    if (some.IsValid() && has_data) {
+        layout.encoding = OptionalEncoding::Flag;
+        layout.word_offset = some.GetOffsetInBytes();
+        layout.word_size = (uint32_t)some.GetType().GetByteSize();
+        return layout;
+    }
+    if (ptr.IsValid() && has_len) {
+        layout.encoding = OptionalEncoding::NullSlicePtr;
+        layout.word_offset = ptr.GetOffsetInBytes();
+        layout.word_size = (uint32_t)ptr.GetType().GetByteSize();
+        return layout;
+    }
+
+    // Optional pointers (?*T, ?[*]T) appear to LLDB as plain pointers
+    const char* type_name = type.GetName();
+    bool pointer_name = type_name && type_name[0] == '?' &&
+        (type_name[1] == '*' || (type_name[1] == '[' && type_name[2] == '*'));
+    if (canonical.IsPointerType() || pointer_name) {
+        layout.encoding = OptionalEncoding::NullPointer;
+        layout.word_size = (uint32_t)canonical.GetByteSize();
+        return layout;
+    }
+
+    // ?E for an ordinary enum is a { data, some } struct (handled above);
+    // only optional error sets reach here, stored as the error value with
+    // no error (0) meaning null
+    if (canonical.GetTypeClass() == eTypeClassEnumeration) {
+        layout.encoding = OptionalEncoding::ErrorSetZero;
+        layout.word_size = (uint32_t)canonical.GetByteSize();
+    }
+    return layout;
 }
 
-static bool ZigArrayListSummary(SBValue value, SBTypeSummaryOptions options, SBStream &stream) {
-    SBValue items = value.GetChildMemberWithName("items");
-    SBValue capacity = value.GetChildMemberWithName("capacity");
+static TypeLayoutCache<OptionalLayout> g_optional_layouts;
 
-    if (items.IsValid()) {
-        SBValue len = items.GetChildMemberWithName("len");
-        if (len.IsValid()) {
-            stream.Printf("len=%llu", (unsigned long long)len.GetValueAsUnsigned(0));
-            if (capacity.IsValid()) {
-                stream.Printf(" capacity=%llu", (unsigned long long)capacity.GetValueAsUnsigned(0));
+static const OptionalLayout& GetOptionalLayout(SBValue value) {
+    return g_optional_layouts.Get(value.GetType(), ClassifyOptional);
+}
+
+enum class OptionalState { Unknown, Null, Some };
+
+// Decide null vs. payload from the one word that encodes it
+static OptionalState DecodeOptional(SBValue value, const OptionalLayout& layout) {
+    if (layout.word_size == 0 || layout.word_size > 8) return OptionalState::Unknown;
+
+    uint8_t bytes[8];
+    if (!ReadValueBytes(value, layout.word_offset, bytes, layout.word_size)) {
+        return OptionalState::Unknown;
+    }
+    uint64_t word = LoadUnsigned(bytes, layout.word_size);
+
+    switch (layout.encoding) {
+    case OptionalEncoding::Flag:
+    case OptionalEncoding::NullPointer:
+    case OptionalEncoding::NullSlicePtr:
+    case OptionalEncoding::ErrorSetZero:
+        return word != 0 ? OptionalState::Some : OptionalState::Null;
+    case OptionalEncoding::Unknown:
+        break;
+    }
+    return OptionalState::Unknown;
+}
+
+//===----------------------------------------------------------------------===//
+// HashMap Layout
+//===----------------------------------------------------------------------===//
+
+// std.HashMapUnmanaged is { metadata: ?[*]Metadata, size, available }. The
+// allocation starts with a Header { values, keys, capacity } that sits right
+// before metadata[0].
+struct HashMapLayout {
+    uint32_t header_size = 24;
+    uint32_t values_offset = 0;
+    uint32_t keys_offset = 8;
+    uint32_t capacity_offset = 16;
+    uint32_t capacity_size = 4;
+    uint32_t max_load_percentage = 80;
+    SBType key_type;        // K and V, when debug info has Header or KV
+    SBType value_type;
+    uint64_t key_size = 0;
+    uint64_t value_size = 0;  // 0 for sets (V = void)
+};
+
+// Managed maps wrap the unmanaged one; pointers are followed once
+static SBValue ResolveHashMapUnmanaged(SBValue value) {
+    if (value.GetType().IsPointerType()) value = value.Dereference();
+    SBValue unmanaged = value.GetChildMemberWithName("unmanaged");
+    return unmanaged.IsValid() ? unmanaged : value;
+}
+
+static HashMapLayout ClassifyHashMap(SBValue map) {
+    HashMapLayout layout;
+    const char* type_name = map.GetTypeName();
+    if (!type_name) return layout;
+    std::string name = type_name;
+
+    // Last generic argument is max_load_percentage: HashMapUnmanaged(K,V,Ctx,80)
+    size_t close = name.rfind(')');
+    size_t comma = name.rfind(',', close);
+    if (close != std::string::npos && comma != std::string::npos) {
+        int pct = atoi(name.c_str() + comma + 1);
+        if (pct > 0 && pct < 100) layout.max_load_percentage = (uint32_t)pct;
+    }
+
+    SBTarget target = map.GetTarget();
+    uint32_t ptr_size = target.GetAddressByteSize();
+    if (ptr_size == 4) {
+        layout.header_size = 12;
+        layout.keys_offset = 4;
+        layout.capacity_offset = 8;
+    }
+
+    // Prefer the real Header layout from debug info when it was emitted
+    SBType header = target.FindFirstType((name + ".Header").c_str());
+    if (header.IsValid() && header.GetByteSize() > 0) {
+        layout.header_size = (uint32_t)header.GetByteSize();
+        for (uint32_t i = 0; i < header.GetNumberOfFields(); i++) {
+            SBTypeMember field = header.GetFieldAtIndex(i);
+            const char* field_name = field.GetName();
+            if (!field_name) continue;
+            uint32_t offset = (uint32_t)field.GetOffsetInBytes();
+            if (strcmp(field_name, "values") == 0) {
+                layout.values_offset = offset;
+                layout.value_type = field.GetType().GetPointeeType();
+            } else if (strcmp(field_name, "keys") == 0) {
+                layout.keys_offset = offset;
+                layout.key_type = field.GetType().GetPointeeType();
+            } else if (strcmp(field_name, "capacity") == 0) {
+                layout.capacity_offset = offset;
+                layout.capacity_size = (uint32_t)field.GetType().GetByteSize();
             }
-            return true;
         }
     }
-    stream.Printf("(ArrayList)");
-    return true;
+
+    if (!layout.key_type.IsValid()) {
+        SBType kv = target.FindFirstType((name + ".KV").c_str());
+        for (uint32_t i = 0; kv.IsValid() && i < kv.GetNumberOfFields(); i++) {
+            SBTypeMember field = kv.GetFieldAtIndex(i);
+            const char* field_name = field.GetName();
+            if (!field_name) continue;
+            if (strcmp(field_name, "key") == 0) layout.key_type = field.GetType();
+            else if (strcmp(field_name, "value") == 0) layout.value_type = field.GetType();
+        }
+    }
+    if (layout.key_type.IsValid()) layout.key_size = layout.key_type.GetByteSize();
+    if (layout.value_type.IsValid()) layout.value_size = layout.value_type.GetByteSize();
+    return layout;
 }
 
-static bool ZigHashMapSummary(SBValue value, SBTypeSummaryOptions options, SBStream &stream) {
-    SBValue size = value.GetChildMemberWithName("size");
-    if (!size.IsValid()) size = value.GetChildMemberWithName("count");
-    if (size.IsValid()) {
-        stream.Printf("size=%llu", (unsigned long long)size.GetValueAsUnsigned(0));
-        return true;
+static TypeLayoutCache<HashMapLayout> g_hash_map_layouts;
+
+struct HashMapState {
+    uint64_t metadata = 0;      // address of metadata[0], 0 when unallocated
+    uint64_t size = 0;
+    uint64_t available = 0;
+    uint64_t capacity = 0;
+    uint64_t keys = 0;
+    uint64_t values = 0;
+};
+
+// Read the map fields plus the allocation header in one extra read
+static bool ReadHashMapState(SBValue map, const HashMapLayout& layout, HashMapState& state) {
+    SBValue metadata = map.GetChildMemberWithName("metadata");
+    SBValue size = map.GetChildMemberWithName("size");
+    if (!metadata.IsValid() || !size.IsValid()) return false;
+
+    state.metadata = metadata.GetValueAsUnsigned(0);
+    state.size = size.GetValueAsUnsigned(0);
+    state.available = map.GetChildMemberWithName("available").GetValueAsUnsigned(0);
+    if (state.metadata == 0) return true;
+
+    uint8_t header[64];
+    if (layout.header_size > sizeof(header) || state.metadata < layout.header_size) return false;
+    SBError error;
+    SBProcess process = map.GetProcess();
+    if (process.ReadMemory(state.metadata - layout.header_size, header, layout.header_size, error)
+            != layout.header_size || error.Fail()) {
+        return false;
     }
-    stream.Printf("(HashMap)");
+    uint32_t ptr_size = process.GetAddressByteSize();
+    state.values = LoadUnsigned(header + layout.values_offset, ptr_size);
+    state.keys = LoadUnsigned(header + layout.keys_offset, ptr_size);
+    state.capacity = LoadUnsigned(header + layout.capacity_offset, layout.capacity_size);
+
+    // Capacity is always a power of two; anything else means garbage memory
+    return state.capacity != 0 && (state.capacity & (state.capacity - 1)) == 0
+        && state.capacity <= (1ull << 32);
+}
+
+// Bulk-read the metadata array and classify it
+static bool ScanHashMap(SBProcess process, const HashMapState& state, zdb::HashMapSlotStats& stats) {
+    if (state.metadata == 0) return false;
+    std::vector<uint8_t> metadata;
+    if (!ReadTargetMemory(process, state.metadata, state.capacity, metadata)) return false;
+    stats = zdb::ScanHashMapMetadata(metadata.data(), metadata.size());
     return true;
 }
 
-static bool ZigBoundedArraySummary(SBValue value, SBTypeSummaryOptions options, SBStream &stream) {
-    SBValue len = value.GetChildMemberWithName("len");
-    if (len.IsValid()) {
-        stream.Printf("len=%llu", (unsigned long long)len.GetValueAsUnsigned(0));
-        return true;
+//===----------------------------------------------------------------------===//
+// HashMap Lookup
+//===----------------------------------------------------------------------===//
+
+// A lookup key in the form the map's context hashes and compares it:
+// StringContext hashes the string bytes; AutoContext hashes the raw bytes
+// of integers, enums, pointers and bool. Integers narrower than their
+// storage (u48, i24) hash only divCeil(@bitSizeOf(K), 8) bytes, so `bytes`
+// holds just those.
+struct HashMapKey {
+    bool is_string = false;
+    std::vector<uint8_t> bytes;
+};
+
+// Parse a Zig string literal body ("a\tb") or take the text as-is
+static std::string UnquoteZigString(const std::string& text) {
+    if (text.size() < 2 || text.front() != '"' || text.back() != '"') return text;
+    std::string out;
+    for (size_t i = 1; i + 1 < text.size(); i++) {
+        char c = text[i];
+        if (c != '\\' || i + 2 >= text.size()) {
+            out += c;
+            continue;
+        }
+        char e = text[++i];
+        switch (e) {
+        case 'n': out += '\n'; break;
+        case 't': out += '\t'; break;
+        case 'r': out += '\r'; break;
+        case 'x':
+            if (i + 2 < text.size()) {
+                out += (char)strtol(text.substr(i + 1, 2).c_str(), nullptr, 16);
+                i += 2;
+            }
+            break;
+        default: out += e; break;
+        }
     }
-    stream.Printf("(BoundedArray)");
-    return true;
+    return out;
 }
 
-static bool ZigMultiArrayListSummary(SBValue value, SBTypeSummaryOptions options, SBStream &stream) {
-    SBValue len = value.GetChildMemberWithName("len");
-    SBValue capacity = value.GetChildMemberWithName("capacity");
-    if (len.IsValid()) {
-        stream.Printf("len=%llu", (unsigned long long)len.GetValueAsUnsigned(0));
-        if (capacity.IsValid()) {
-            stream.Printf(" capacity=%llu", (unsigned long long)capacity.GetValueAsUnsigned(0));
+static bool IsStringSliceType(SBType type) {
+    const char* name = type.GetName();
+    return name && (strcmp(name, "[]u8") == 0 || strcmp(name, "[]const u8") == 0);
+}
+
+// Argument `index` of "module.Generic(A,B(C,D),E)", split at top-level commas
+static std::string TypeNameArgument(const std::string& name, size_t index) {
+    size_t open = name.find('(');
+    if (open == std::string::npos) return "";
+    int nesting = 0;
+    size_t start = open + 1;
+    size_t arg = 0;
+    for (size_t i = start; i < name.size(); i++) {
+        char c = name[i];
+        if (c == '(' || c == '[' || c == '{') {
+            nesting++;
+        } else if ((c == ')' || c == ']' || c == '}') && nesting > 0) {
+            nesting--;
+        } else if ((c == ',' && nesting == 0) || (c == ')' && nesting == 0)) {
+            if (arg == index) return name.substr(start, i - start);
+            arg++;
+            start = i + 1;
         }
-        return true;
     }
-    stream.Printf("(MultiArrayList)");
-    return true;
+    return "";
 }
 
-static bool ZigSegmentedListSummary(SBValue value, SBTypeSummaryOptions options, SBStream &stream) {
-    SBValue len = value.GetChildMemberWithName("len");
-    if (len.IsValid()) {
-        stream.Printf("len=%llu", (unsigned long long)len.GetValueAsUnsigned(0));
+// Only the built-in contexts hash the way the plugin does; a custom
+// context's hash function is inferior code. `module` is "hash_map" or
+// "array_hash_map", whose AutoContext/StringContext the map must name as
+// its Context argument.
+static bool HashMapContextSupported(SBValue map, const std::string& module, std::string& error) {
+    const char* name = map.GetType().GetName();
+    std::string context = TypeNameArgument(name ? name : "", 2);
+    if (context == module + ".StringContext" || context.compare(0, module.size() + 13, module + ".AutoContext(") == 0) {
         return true;
     }
-    stream.Printf("(SegmentedList)");
-    return true;
+    error = "error: map uses a custom hash context (" + (context.empty() ? std::string("unknown") : context) +
+            "); native lookup supports only " + module + ".AutoContext and " + module + ".StringContext";
+    return false;
 }
 
-static bool ZigCStringSummary(SBValue value, SBTypeSummaryOptions options, SBStream &stream) {
-    uint64_t ptr_val = value.GetValueAsUnsigned(0);
-    if (ptr_val == 0) {
-        stream.Printf("null");
+// Bytes of an integer or enum key that autoHash covers: divCeil(bits, 8)
+// from the integer type's name ("u48"), else the full size
+static uint64_t AutoHashKeySize(SBType key_type, uint64_t key_size) {
+    SBType canonical = key_type.GetCanonicalType();
+    if (canonical.GetTypeClass() == eTypeClassEnumeration) canonical = canonical.GetEnumerationIntegerType();
+    const char* name = canonical.GetName();
+    unsigned bits = 0;
+    if (!name || (name[0] != 'u' && name[0] != 'i') || sscanf(name + 1, "%u", &bits) != 1 || bits == 0) {
+        return key_size;
+    }
+    return std::min<uint64_t>(key_size, (bits + 7) / 8);
+}
+
+static bool EncodeHashMapKey(SBType key_type, uint64_t key_size, const std::string& text,
+                             HashMapKey& key, std::string& error) {
+    if (IsStringSliceType(key_type)) {
+        std::string str = UnquoteZigString(text);
+        key.is_string = true;
+        key.bytes.assign(str.begin(), str.end());
         return true;
     }
-    SBProcess process = value.GetProcess();
-    if (process.IsValid()) {
-        char buffer[256];
-        SBError error;
-        size_t bytes_read = process.ReadCStringFromMemory(ptr_val, buffer, sizeof(buffer), error);
-        if (bytes_read > 0 && error.Success()) {
-            stream.Printf("\"%s\"", buffer);
-            return true;
+
+    SBType canonical = key_type.GetCanonicalType();
+    uint64_t raw = 0;
+    if (canonical.GetTypeClass() == eTypeClassEnumeration) {
+        std::string name = text[0] == '.' ? text.substr(1) : text;
+        SBTypeEnumMemberList members = canonical.GetEnumMembers();
+        bool matched = false;
+        for (uint32_t i = 0; i < members.GetSize() && !matched; i++) {
+            SBTypeEnumMember member = members.GetTypeEnumMemberAtIndex(i);
+            if (member.GetName() && name == member.GetName()) {
+                raw = member.GetValueAsUnsigned();
+                matched = true;
+            }
         }
+        if (!matched) raw = strtoull(text.c_str(), nullptr, 0);
+    } else if (canonical.GetBasicType() == eBasicTypeBool ||
+               (canonical.GetName() && strcmp(canonical.GetName(), "bool") == 0)) {
+        if (text != "true" && text != "false") {
+            error = "error: bool key must be true or false";
+            return false;
+        }
+        raw = text == "true";
+    } else if (canonical.GetTypeClass() == eTypeClassBuiltin || canonical.IsPointerType()) {
+        char* end = nullptr;
+        raw = text[0] == '-' ? (uint64_t)strtoll(text.c_str(), &end, 0)
+                             : strtoull(text.c_str(), &end, 0);
+        if (!end || *end) {
+            error = "error: cannot parse key '" + text + "'";
+            return false;
+        }
+    } else {
+        error = std::string("error: unsupported key type ") + (key_type.GetName() ? key_type.GetName() : "?");
+        return false;
     }
-    stream.Printf("0x%llx", (unsigned long long)ptr_val);
+    if (key_size > 8) {
+        error = "error: keys wider than 8 bytes are not supported";
+        return false;
+    }
+    key.bytes.resize(AutoHashKeySize(key_type, key_size));
+    for (size_t i = 0; i < key.bytes.size(); i++) key.bytes[i] = (uint8_t)(raw >> (8 * i));
     return true;
 }
 
-static bool ZigArraySummary(SBValue value, SBTypeSummaryOptions options, SBStream &stream) {
-    uint32_t num = value.GetNumChildren();
-    stream.Printf("[%u]...", num);
-    return true;
-}
+struct HashMapLookup {
+    bool found = false;
+    uint64_t slot = 0;
+    uint64_t value_addr = 0;
+    uint32_t probes = 0;    // candidate keys compared
+    uint32_t reads = 0;     // memory reads issued
+};
 
-static bool ZigPointerSummary(SBValue value, SBTypeSummaryOptions options, SBStream &stream) {
-    uint64_t ptr_val = value.GetValueAsUnsigned(0);
-    if (ptr_val == 0) {
-        stream.Printf("null");
-        return true;
+// Compare the stored key at key_addr with the lookup key. String keys are
+// { ptr, len } slices; their bytes are read only when the length matches.
+static bool KeyMatchesAt(SBProcess process, const HashMapKey& key, uint64_t key_addr,
+                         HashMapLookup& out) {
+    SBError error;
+    std::vector<uint8_t> stored(key.bytes.size());
+    out.probes++;
+    out.reads++;
+    if (key.is_string) {
+        uint32_t ptr_size = process.GetAddressByteSize();
+        uint8_t slice[16];
+        if (process.ReadMemory(key_addr, slice, 2 * ptr_size, error) != 2 * ptr_size) return false;
+        uint64_t str_ptr = LoadUnsigned(slice, ptr_size);
+        uint64_t str_len = LoadUnsigned(slice + ptr_size, ptr_size);
+        if (str_len != key.bytes.size()) return false;
+        if (str_len == 0) return true;
+        out.reads++;
+        return process.ReadMemory(str_ptr, stored.data(), str_len, error) == str_len &&
+            memcmp(stored.data(), key.bytes.data(), str_len) == 0;
     }
-    SBValue deref = value.Dereference();
-    if (deref.IsValid()) {
-        const char* summary = deref.GetSummary();
-        if (summary && summary[0]) {
-            stream.Printf("-> %s", summary);
-            return true;
+    return process.ReadMemory(key_addr, stored.data(), stored.size(), error) == stored.size() &&
+        memcmp(stored.data(), key.bytes.data(), stored.size()) == 0;
+}
+
+// Probe the map like HashMapUnmanaged.getIndex: start at hash & mask, scan
+// metadata forward for the key's fingerprint until a free slot, and compare
+// only the candidate keys. Metadata is read in growing windows.
+static bool LookupHashMap(SBProcess process, const HashMapLayout& layout, const HashMapState& state,
+                          const HashMapKey& key, HashMapLookup& out) {
+    if (state.metadata == 0 || state.capacity == 0) return true;
+
+    uint64_t hash = zdb::Wyhash::Hash(0, key.bytes.data(), key.bytes.size());
+    uint64_t mask = state.capacity - 1;
+    uint8_t tag = zdb::kMetadataUsedBit | (uint8_t)(hash >> 57);
+    uint64_t idx = hash & mask;
+    uint64_t limit = state.capacity;
+    uint64_t window = 64;
+
+    std::vector<uint8_t> metadata;
+    std::vector<size_t> candidates;
+
+    while (limit > 0) {
+        uint64_t n = std::min(std::min(window, state.capacity - idx), limit);
+        SBError error;
+        metadata.resize(n);
+        out.reads++;
+        if (process.ReadMemory(state.metadata + idx, metadata.data(), n, error) != n || error.Fail()) {
+            return false;
         }
-        const char* val = deref.GetValue();
-        if (val && val[0]) {
-            stream.Printf("-> %s", val);
-            return true;
+        candidates.clear();
+        bool ended = zdb::FindProbeCandidates(metadata.data(), n, tag, candidates);
+
+        for (size_t c : candidates) {
+            uint64_t slot = idx + c;
+            if (KeyMatchesAt(process, key, state.keys + slot * layout.key_size, out)) {
+                out.found = true;
+                out.slot = slot;
+                out.value_addr = state.values + slot * layout.value_size;
+                return true;
+            }
         }
+        if (ended) return true;
+
+        limit -= n;
+        idx = (idx + n) & mask;
+        window = std::min<uint64_t>(window * 4, 64 * 1024);
     }
-    stream.Printf("0x%llx", (unsigned long long)ptr_val);
     return true;
 }
 
-static bool ZigStructSummary(SBValue value, SBTypeSummaryOptions options, SBStream &stream) {
-    uint32_t num_children = value.GetNumChildren();
+//===----------------------------------------------------------------------===//
+// MultiArrayList Layout
+//===----------------------------------------------------------------------===//
 
-    // Enum: no children, has a value
-    if (num_children == 0) {
-        const char* val = value.GetValue();
-        if (val && val[0]) {
-            stream.Printf(".%s", val);
-            return true;
+// Zig's alignment for the types debug info describes: scalars align to their
+// size (capped at 16), arrays to their element, aggregates to their most
+// aligned field.
+static uint64_t TypeAlignment(SBType type) {
+    SBType t = type.GetCanonicalType();
+    uint64_t size = t.GetByteSize();
+    if (size == 0) return 1;
+    if (t.IsArrayType()) return TypeAlignment(t.GetArrayElementType());
+    TypeClass type_class = t.GetTypeClass();
+    if ((type_class == eTypeClassStruct || type_class == eTypeClassUnion) && t.GetNumberOfFields() > 0) {
+        uint64_t align = 1;
+        for (uint32_t i = 0; i < t.GetNumberOfFields(); i++) {
+            align = std::max(align, TypeAlignment(t.GetFieldAtIndex(i).GetType()));
         }
-        stream.Printf("{}");
-        return true;
+        return align;
     }
+    uint64_t align = 1;
+    while (align < size && align < 16) align <<= 1;
+    return align;
+}
 
-    // Small structs: show inline
-    if (num_children <= 3) {
-        stream.Printf("{ ");
-        for (uint32_t i = 0; i < num_children; i++) {
-            if (i > 0) stream.Printf(", ");
-            SBValue child = value.GetChildAtIndex(i);
-            if (child.IsValid()) {
-                const char* name = child.GetName();
-                const char* summary = child.GetSummary();
-                if (summary && summary[0]) {
-                    stream.Printf(".%s=%s", name ? name : "?", summary);
-                } else {
-                    const char* val = child.GetValue();
-                    if (val && val[0]) {
-                        stream.Printf(".%s=%s", name ? name : "?", val);
-                    }
-                }
-            }
+// MultiArrayList(T) stores each field of T as a column inside one `bytes`
+// allocation. Columns are ordered by alignment (descending, stable), so
+// column i starts at bytes + capacity * (sum of sizes of earlier columns).
+struct MultiArrayListColumn {
+    std::string name;
+    SBType type;
+    uint64_t size = 0;
+    uint64_t offset_per_capacity = 0;
+};
+
+struct MultiArrayListLayout {
+    std::vector<MultiArrayListColumn> columns;  // in T's field order
+
+    const MultiArrayListColumn* Find(const char* name) const {
+        for (const MultiArrayListColumn& column : columns) {
+            if (column.name == name) return &column;
         }
-        stream.Printf(" }");
-        return true;
+        return nullptr;
     }
+};
 
-    stream.Printf("{ %u fields }", num_children);
-    return true;
+// Element type name from "multi_array_list.MultiArrayList(T)"
+static std::string MultiArrayListElementName(const char* type_name) {
+    if (!type_name) return "";
+    std::string name = type_name;
+    size_t open = name.find('(');
+    size_t close = name.rfind(')');
+    if (open == std::string::npos || close == std::string::npos || close <= open) return "";
+    return name.substr(open + 1, close - open - 1);
 }
 
-// shared_ptr layout: { T* ptr, control_block* ctrl }
-struct SharedPtrLayout {
-    void* ptr;
-    void* ctrl;
-};
+static MultiArrayListLayout ClassifyMultiArrayListType(SBTarget target, const char* type_name) {
+    MultiArrayListLayout layout;
+    std::string elem_name = MultiArrayListElementName(type_name);
+    if (elem_name.empty()) return layout;
+    SBType elem = target.FindFirstType(elem_name.c_str());
+    if (!elem.IsValid()) return layout;
+    elem = elem.GetCanonicalType();
 
-//===----------------------------------------------------------------------===//
-// ABI-Compatible Types for Internal API
-//===----------------------------------------------------------------------===//
+    std::vector<uint64_t> aligns;
+    for (uint32_t i = 0; i < elem.GetNumberOfFields(); i++) {
+        SBTypeMember field = elem.GetFieldAtIndex(i);
+        MultiArrayListColumn column;
+        column.name = field.GetName() ? field.GetName() : "";
+        column.type = field.GetType();
+        column.size = column.type.GetByteSize();
+        layout.columns.push_back(column);
+        aligns.push_back(column.size == 0 ? 1 : TypeAlignment(column.type));
+    }
 
-// llvm::StringRef: passed as { const char*, size_t } on ARM64
-// On Apple ARM64, small structs (<=16 bytes) passed in registers
+    std::vector<size_t> order(layout.columns.size());
+    for (size_t i = 0; i < order.size(); i++) order[i] = i;
+    std::stable_sort(order.begin(), order.end(),
+        [&](size_t a, size_t b) { return aligns[a] > aligns[b]; });
+    uint64_t offset = 0;
+    for (size_t i : order) {
+        layout.columns[i].offset_per_capacity = offset;
+        offset += layout.columns[i].size;
+    }
+    return layout;
+}
 
-// Note: SharedPtrLayout defined earlier in synthetic section
+static MultiArrayListLayout ClassifyMultiArrayList(SBValue list) {
+    return ClassifyMultiArrayListType(list.GetTarget(), list.GetTypeName());
+}
 
-// ConstString is just a const char* wrapper
-struct ConstString {
-    const char* m_string;
-    ConstString(const char* s) : m_string(s) {}
+static TypeLayoutCache<MultiArrayListLayout> g_multi_array_list_layouts;
+
+struct MultiArrayListState {
+    uint64_t bytes = 0;
+    uint64_t len = 0;
+    uint64_t capacity = 0;
+
+    uint64_t ColumnAddress(const MultiArrayListColumn& column, uint64_t index = 0) const {
+        return bytes + capacity * column.offset_per_capacity + index * column.size;
+    }
 };
 
+static bool ReadMultiArrayListState(SBValue list, MultiArrayListState& state) {
+    SBValue bytes = list.GetChildMemberWithName("bytes");
+    SBValue len = list.GetChildMemberWithName("len");
+    SBValue capacity = list.GetChildMemberWithName("capacity");
+    if (!bytes.IsValid() || !len.IsValid() || !capacity.IsValid()) return false;
+    state.bytes = bytes.GetValueAsUnsigned(0);
+    state.len = len.GetValueAsUnsigned(0);
+    state.capacity = capacity.GetValueAsUnsigned(0);
+    return state.len <= state.capacity;
+}
+
+// Read rows [first, first + count) of one column in a single read
+static bool ReadMultiArrayListColumn(SBProcess process, const MultiArrayListState& state,
+                                     const MultiArrayListColumn& column, uint64_t first,
+                                     uint64_t count, std::vector<uint8_t>& out) {
+    if (column.size == 0) {
+        out.clear();
+        return true;
+    }
+    return ReadTargetMemory(process, state.ColumnAddress(column, first), count * column.size, out);
+}
+
+static bool IsZigMultiArrayList(SBValue value) {
+    const char* name = value.GetTypeName();
+    return name && strncmp(name, "multi_array_list.MultiArrayList(", 32) == 0;
+}
+
+// Address and type of list.items(.field)[index]
+static bool ZigMultiArrayListElement(SBValue list, const std::string& field, uint64_t index,
+                                     uint64_t& addr, SBType& type, std::string& error) {
+    if (list.GetType().IsPointerType()) list = list.Dereference();
+    MultiArrayListState state;
+    if (!IsZigMultiArrayList(list) || !ReadMultiArrayListState(list, state)) {
+        error = "error: not a std.MultiArrayList";
+        return false;
+    }
+    const MultiArrayListLayout& layout = g_multi_array_list_layouts.Get(list, ClassifyMultiArrayList);
+    const MultiArrayListColumn* column = layout.Find(field.c_str());
+    if (!column) {
+        error = "error: no field '" + field + "' (or element type not in debug info)";
+        return false;
+    }
+    if (index >= state.len) {
+        error = "error: index " + std::to_string(index) + " out of bounds (len " + std::to_string(state.len) + ")";
+        return false;
+    }
+    addr = state.ColumnAddress(*column, index);
+    type = column->type;
+    return true;
+}
+
 //===----------------------------------------------------------------------===//
-// Internal API Registration
+// ArrayHashMap
 //===----------------------------------------------------------------------===//
 
-// Function pointer types matching LLDB internal ABI
-// GetCategory: void(ConstString, shared_ptr<TypeCategoryImpl>&, bool)
-// On ARM64: x0=ConstString (8 bytes), x1=&out_sp, x2=bool
-using GetCategoryFn = void (*)(
-    const char* name,           // ConstString passed as raw pointer
-    SharedPtrLayout* out_sp,    // Output: shared_ptr<TypeCategoryImpl>
-    bool can_create
-);
+// std.ArrayHashMapUnmanaged keeps { entries: MultiArrayList(Data), index_header }.
+// Data is { hash: u32 or void, key: K, value: V }; small maps have no index
+// header and are searched linearly.
+struct ArrayHashMapView {
+    SBValue map;        // the unmanaged map
+    SBValue entries;
+    const MultiArrayListLayout* layout = nullptr;
+    const MultiArrayListColumn* hashes = nullptr;   // null when hashes aren't stored
+    const MultiArrayListColumn* keys = nullptr;
+    const MultiArrayListColumn* values = nullptr;
+    MultiArrayListState state;
+    uint64_t index_header = 0;
+};
 
-// Enable: void(const shared_ptr<TypeCategoryImpl>&, uint32_t)
-using EnableFn = void (*)(
-    const SharedPtrLayout* category_sp,
-    uint32_t position
-);
+static SBValue ResolveArrayHashMapUnmanaged(SBValue value) {
+    if (value.GetType().IsPointerType()) value = value.Dereference();
+    SBValue unmanaged = value.GetChildMemberWithName("unmanaged");
+    return unmanaged.IsValid() ? unmanaged : value;
+}
 
-// AddTypeSummary: member function
-// void TypeCategoryImpl::AddTypeSummary(StringRef, FormatterMatchType, shared_ptr<TypeSummaryImpl>)
-// On ARM64: non-trivial types passed indirectly (pointer to struct)
-using AddTypeSummaryFn = void (*)(
-    void* this_ptr,             // TypeCategoryImpl*
-    const char* name_ptr,       // StringRef.data
-    size_t name_len,            // StringRef.length
-    int match_type,             // FormatterMatchType enum
-    SharedPtrLayout* sp         // shared_ptr passed indirectly
-);
+static bool IsZigArrayHashMap(SBValue value) {
+    const char* name = ResolveArrayHashMapUnmanaged(value).GetTypeName();
+    return name && strncmp(name, "array_hash_map.", 15) == 0;
+}
 
-static bool RegisterFormatter(
-    void* category_impl,
-    AddTypeSummaryFn add_fn,
-    const char* pattern,
-    bool (*callback)(SBValue, SBTypeSummaryOptions, SBStream&),
-    const char* description,
-    bool is_regex = true,
-    bool hide_children = false
-) {
-    uint32_t options = eTypeOptionCascade;
-    if (hide_children) {
-        options |= eTypeOptionHideChildren;
-    }
-    SBTypeSummary summary = SBTypeSummary::CreateWithCallback(
-        callback, options, description);
+static bool GetArrayHashMapView(SBValue value, ArrayHashMapView& view) {
+    view.map = ResolveArrayHashMapUnmanaged(value);
+    view.entries = view.map.GetChildMemberWithName("entries");
+    if (!view.entries.IsValid() || !ReadMultiArrayListState(view.entries, view.state)) return false;
+    view.layout = &g_multi_array_list_layouts.Get(view.entries, ClassifyMultiArrayList);
+    view.keys = view.layout->Find("key");
+    view.values = view.layout->Find("value");
+    view.hashes = view.layout->Find("hash");
+    if (view.hashes && view.hashes->size != 4) view.hashes = nullptr;
+    view.index_header = view.map.GetChildMemberWithName("index_header").GetValueAsUnsigned(0);
+    return view.keys != nullptr;
+}
 
-    if (!summary.IsValid()) return false;
+// IndexHeader { bit_index: u8 align(4) } is followed by 1 << bit_index
+// Index(I) { entry_index: I, distance_from_start_index: I } slots, where I
+// is the narrowest of u8/u16/u32 that can hold the header's capacity.
+static constexpr uint64_t kIndexHeaderSize = 4;
 
-    g_formatters.push_back(summary);
+static bool LookupArrayHashMapIndexed(SBProcess process, const ArrayHashMapView& view,
+                                      const HashMapKey& key, uint32_t hash, HashMapLookup& out) {
+    SBError error;
+    uint8_t bit_index = 0;
+    out.reads++;
+    if (process.ReadMemory(view.index_header, &bit_index, 1, error) != 1 || bit_index > 32) return false;
 
-    // Extract shared_ptr from SBTypeSummary (only contains m_opaque_sp)
-    SharedPtrLayout* sp = (SharedPtrLayout*)&summary;
+    uint64_t length = 1ull << bit_index;
+    uint64_t capacity = length * 3 / 5;
+    uint32_t index_size = capacity <= 0xff ? 1 : capacity <= 0xffff ? 2 : capacity <= 0xffffffffull ? 4 : 8;
+    uint64_t empty = index_size == 8 ? ~0ull : (1ull << (8 * index_size)) - 1;
+    uint64_t slot_size = 2 * index_size;
+    uint64_t indexes = view.index_header + kIndexHeaderSize;
+    uint64_t mask = length - 1;
 
-    // Call internal AddTypeSummary
-    // FormatterMatchType: 0=Exact, 1=Regex, 2=Callback
-    add_fn(
-        category_impl,
-        pattern, strlen(pattern),
-        is_regex ? 1 : 0,
-        sp  // ARM64: non-trivial types passed indirectly
-    );
+    std::vector<uint8_t> window;
+    uint64_t distance = 0;
+    uint64_t slot = hash & mask;
+    uint64_t batch = 16;
+    while (distance < length) {
+        uint64_t n = std::min(std::min(batch, length - slot), length - distance);
+        out.reads++;
+        if (!ReadTargetMemory(process, indexes + slot * slot_size, n * slot_size, window)) return false;
+        for (uint64_t i = 0; i < n; i++, distance++) {
+            const uint8_t* entry = window.data() + i * slot_size;
+            uint64_t entry_index = LoadUnsigned(entry, index_size);
+            uint64_t entry_distance = LoadUnsigned(entry + index_size, index_size);
+            if (entry_index == empty || entry_distance < distance) return true;
+            if (entry_index >= view.state.len) continue;
+
+            if (view.hashes) {
+                uint8_t stored[4];
+                out.reads++;
+                if (process.ReadMemory(view.state.ColumnAddress(*view.hashes, entry_index), stored, 4, error) != 4) {
+                    return false;
+                }
+                if ((uint32_t)LoadUnsigned(stored, 4) != hash) continue;
+            }
+            if (KeyMatchesAt(process, key, view.state.ColumnAddress(*view.keys, entry_index), out)) {
+                out.found = true;
+                out.slot = entry_index;
+                if (view.values) out.value_addr = view.state.ColumnAddress(*view.values, entry_index);
+                return true;
+            }
+        }
+        slot = (slot + n) & mask;
+        batch = std::min<uint64_t>(batch * 4, 16 * 1024);
+    }
+    return true;
+}
 
+// No index: bulk-read the hashes column and vector-compare it, or compare
+// keys in order when hashes aren't stored
+static bool LookupArrayHashMapLinear(SBProcess process, const ArrayHashMapView& view,
+                                     const HashMapKey& key, uint32_t hash, HashMapLookup& out) {
+    std::vector<size_t> candidates;
+    if (view.hashes) {
+        std::vector<uint8_t> column;
+        out.reads++;
+        if (!ReadMultiArrayListColumn(process, view.state, *view.hashes, 0, view.state.len, column)) return false;
+        std::vector<uint32_t> words(view.state.len);
+        memcpy(words.data(), column.data(), view.state.len * sizeof(uint32_t));
+        zdb::FindU32Matches(words.data(), words.size(), hash, candidates);
+    } else {
+        for (size_t i = 0; i < view.state.len; i++) candidates.push_back(i);
+    }
+    for (size_t i : candidates) {
+        if (KeyMatchesAt(process, key, view.state.ColumnAddress(*view.keys, i), out)) {
+            out.found = true;
+            out.slot = i;
+            if (view.values) out.value_addr = view.state.ColumnAddress(*view.values, i);
+            return true;
+        }
+    }
     return true;
 }
 
-// Resolve liblldb path from the running process using dladdr
-static std::string ResolveLibLLDBPath() {
-    // 1. Check environment variable
-    const char* env_path = getenv("ZDB_LIBLLDB_PATH");
-    if (env_path && env_path[0]) {
-        return env_path;
+static bool ZigArrayHashMapGet(SBValue value, const std::string& key_text, HashMapLookup& lookup,
+                               SBType& value_type, std::string& error) {
+    ArrayHashMapView view;
+    if (!GetArrayHashMapView(value, view)) {
+        error = "error: not a std.ArrayHashMap (or its entry type is not in debug info)";
+        return false;
     }
+    if (!HashMapContextSupported(view.map, "array_hash_map", error)) return false;
+    HashMapKey key;
+    if (!EncodeHashMapKey(view.keys->type, view.keys->size, key_text, key, error)) return false;
 
-    // 2. Use dladdr on SBDebugger::GetVersionString to find loaded liblldb
-    Dl_info info;
-    if (dladdr((void*)&SBDebugger::GetVersionString, &info) && info.dli_fname) {
-        return info.dli_fname;
+    // array_hash_map contexts truncate the 64-bit Wyhash to u32
+    uint32_t hash = (uint32_t)zdb::Wyhash::Hash(0, key.bytes.data(), key.bytes.size());
+    SBProcess process = view.map.GetProcess();
+    bool ok = view.index_header
+        ? LookupArrayHashMapIndexed(process, view, key, hash, lookup)
+        : LookupArrayHashMapLinear(process, view, key, hash, lookup);
+    if (!ok) {
+        error = "error: failed to read map memory";
+        return false;
     }
+    if (view.values) value_type = view.values->type;
+    return true;
+}
 
-    // 3. Platform-specific fallbacks
-#if defined(__APPLE__)
-    // Try Homebrew ARM64 first, then x86_64
-    const char* fallbacks[] = {
-        "/opt/homebrew/opt/llvm/lib/liblldb.dylib",
-        "/usr/local/opt/llvm/lib/liblldb.dylib",
-        "/Library/Developer/CommandLineTools/usr/lib/liblldb.dylib",
-        nullptr
-    };
-#else
-    // Linux fallbacks
-    const char* fallbacks[] = {
-        "/usr/lib/llvm-18/lib/liblldb.so",
-        "/usr/lib/llvm-17/lib/liblldb.so",
-        "/usr/lib/liblldb.so",
-        nullptr
-    };
-#endif
-    for (const char** p = fallbacks; *p; ++p) {
-        if (access(*p, R_OK) == 0) {
-            return *p;
+//===----------------------------------------------------------------------===//
+// SegmentedList
+//===----------------------------------------------------------------------===//
+
+// SegmentedList(T, prealloc) is { prealloc_segment: [prealloc]T,
+// dynamic_segments: [][*]T, len }. Elements past the prealloc segment live
+// on shelves of doubling size: shelf s holds 1 << (s + log2(prealloc) + 1)
+// elements (1 << s when prealloc is 0).
+struct SegmentedListLayout {
+    bool valid = false;
+    uint64_t prealloc_count = 0;
+    uint64_t prealloc_exp = 0;
+    uint64_t prealloc_offset = 0;
+    uint64_t segments_offset = 0;   // dynamic_segments.ptr; .len follows it
+    uint64_t len_offset = 0;
+    uint64_t word_size = 8;
+    SBType element_type;
+    uint64_t element_size = 0;
+};
+
+static uint64_t Log2Floor(uint64_t x) {
+    return 63 - __builtin_clzll(x);
+}
+
+static SegmentedListLayout ClassifySegmentedList(SBType type) {
+    SegmentedListLayout layout;
+    type = type.GetCanonicalType();
+    bool have_segments = false, have_len = false;
+    uint64_t prealloc_bytes = 0;
+    for (uint32_t i = 0; i < type.GetNumberOfFields(); i++) {
+        SBTypeMember field = type.GetFieldAtIndex(i);
+        const char* name = field.GetName();
+        if (!name) continue;
+        if (strcmp(name, "prealloc_segment") == 0) {
+            layout.prealloc_offset = field.GetOffsetInBytes();
+            prealloc_bytes = field.GetType().GetByteSize();
+        } else if (strcmp(name, "dynamic_segments") == 0) {
+            // [][*]T -> ptr: [*][*]T -> [*]T -> T
+            SBType slice = field.GetType().GetCanonicalType();
+            if (slice.GetNumberOfFields() < 2) continue;
+            layout.segments_offset = field.GetOffsetInBytes();
+            layout.word_size = slice.GetFieldAtIndex(0).GetType().GetByteSize();
+            layout.element_type = slice.GetFieldAtIndex(0).GetType().GetPointeeType().GetPointeeType();
+            layout.element_size = layout.element_type.GetByteSize();
+            have_segments = layout.element_type.IsValid();
+        } else if (strcmp(name, "len") == 0) {
+            layout.len_offset = field.GetOffsetInBytes();
+            have_len = true;
         }
     }
+    if (!have_segments || !have_len || layout.element_size == 0) return layout;
+    layout.prealloc_count = prealloc_bytes / layout.element_size;
+    // prealloc is a power of two by construction
+    if (layout.prealloc_count & (layout.prealloc_count - 1)) return layout;
+    layout.prealloc_exp = layout.prealloc_count ? Log2Floor(layout.prealloc_count) : 0;
+    layout.valid = true;
+    return layout;
+}
 
-    return "";
+static TypeLayoutCache<SegmentedListLayout> g_segmented_list_layouts;
+
+struct SegmentedListState {
+    uint64_t len = 0;
+    uint64_t segments = 0;        // address of the shelf pointer array
+    uint64_t segment_count = 0;
+};
+
+// Shelf and box (index within the shelf) of a list index past the prealloc segment
+static void SegmentedListPosition(const SegmentedListLayout& layout, uint64_t index,
+                                  uint64_t& shelf, uint64_t& box) {
+    if (layout.prealloc_count == 0) {
+        shelf = Log2Floor(index + 1);
+        box = index + 1 - (1ull << shelf);
+    } else {
+        shelf = Log2Floor(index + layout.prealloc_count) - layout.prealloc_exp - 1;
+        box = index + layout.prealloc_count - (1ull << (layout.prealloc_exp + 1 + shelf));
+    }
 }
 
-static bool RegisterWithInternalAPI(SBDebugger debugger) {
-    // Get LLDB version - handle multiple formats:
-    // - Homebrew/upstream: "lldb version 21.1.7 ..."
-    // - Apple Xcode: "lldb-1703.0.234.3\nApple Swift version 6.2.1 ..."
-    // Check lldb- prefix FIRST (Apple format) to avoid matching "Swift version"
-    const char* version_str = SBDebugger::GetVersionString();
-    const char* ver;
-    if (strncmp(version_str, "lldb-", 5) == 0) {
-        ver = version_str + 5;  // Skip "lldb-"
-    } else if ((ver = strstr(version_str, "lldb version ")) != nullptr) {
-        ver += 13;  // Skip "lldb version "
-    } else {
-        // Try to find any leading digits
-        ver = version_str;
-        while (*ver && !isdigit(*ver)) ver++;
-        if (!*ver) {
-            fprintf(stderr, "[zdb] Could not parse LLDB version from: %s\n", version_str);
-            return false;
-        }
+static uint64_t SegmentedListShelfSize(const SegmentedListLayout& layout, uint64_t shelf) {
+    if (layout.prealloc_count == 0) return 1ull << shelf;
+    return 1ull << (shelf + layout.prealloc_exp + 1);
+}
+
+static bool IsZigSegmentedList(SBValue value) {
+    const char* name = value.GetTypeName();
+    return name && strncmp(name, "segmented_list.SegmentedList(", 29) == 0;
+}
+
+// The header fields come from the value's own data, no memory read
+static bool ReadSegmentedListState(SBValue list, const SegmentedListLayout& layout,
+                                   SegmentedListState& state) {
+    if (!layout.valid) return false;
+    uint8_t word[8];
+    if (!ReadValueBytes(list, layout.len_offset, word, layout.word_size)) return false;
+    state.len = LoadUnsigned(word, layout.word_size);
+    if (!ReadValueBytes(list, layout.segments_offset, word, layout.word_size)) return false;
+    state.segments = LoadUnsigned(word, layout.word_size);
+    if (!ReadValueBytes(list, layout.segments_offset + layout.word_size, word, layout.word_size)) return false;
+    state.segment_count = LoadUnsigned(word, layout.word_size);
+    return true;
+}
+
+// Address of element `index`: prealloc elements sit inside the list itself;
+// the rest cost one pointer read for their shelf
+static bool SegmentedListElementAddress(SBValue list, const SegmentedListLayout& layout,
+                                        const SegmentedListState& state, uint64_t index, uint64_t& addr) {
+    if (index < layout.prealloc_count) {
+        uint64_t base = list.GetLoadAddress();
+        if (base == LLDB_INVALID_ADDRESS) return false;
+        addr = base + layout.prealloc_offset + index * layout.element_size;
+        return true;
     }
+    uint64_t shelf, box;
+    SegmentedListPosition(layout, index, shelf, box);
+    if (shelf >= state.segment_count) return false;
+    SBError error;
+    addr = list.GetProcess().ReadPointerFromMemory(state.segments + shelf * layout.word_size, error);
+    if (error.Fail() || addr == 0) return false;
+    addr += box * layout.element_size;
+    return true;
+}
 
-    char version[32];
-    int i = 0;
-    while (ver[i] && (isdigit(ver[i]) || ver[i] == '.') && i < 31) {
-        version[i] = ver[i];
-        i++;
+// Copy elements [0, count) into `out`: the prealloc part from the value's
+// data, then one read for the shelf pointers and one read per shelf
+static bool ReadSegmentedListPrefix(SBValue list, const SegmentedListLayout& layout,
+                                    const SegmentedListState& state, uint64_t count,
+                                    std::vector<uint8_t>& out) {
+    out.assign(count * layout.element_size, 0);
+    uint64_t in_prealloc = std::min(count, layout.prealloc_count);
+    if (in_prealloc > 0 &&
+        !ReadValueBytes(list, layout.prealloc_offset, out.data(), in_prealloc * layout.element_size)) {
+        return false;
     }
-    version[i] = '\0';
+    if (count <= in_prealloc) return true;
 
-    // Resolve liblldb path dynamically
-    std::string liblldb_path = ResolveLibLLDBPath();
-    if (liblldb_path.empty()) {
-        fprintf(stderr, "[zdb] Could not find liblldb. Set ZDB_LIBLLDB_PATH env var.\n");
+    uint64_t last_shelf, last_box;
+    SegmentedListPosition(layout, count - 1, last_shelf, last_box);
+    if (last_shelf >= state.segment_count) return false;
+    SBProcess process = list.GetProcess();
+    std::vector<uint8_t> shelves;
+    if (!ReadTargetMemory(process, state.segments, (last_shelf + 1) * layout.word_size, shelves)) {
         return false;
     }
 
-    // Load offsets
-    if (!zdb::g_symbols.load(liblldb_path.c_str(), version)) {
-        fprintf(stderr, "[zdb] No offsets for LLDB %s\n", version);
+    uint64_t index = in_prealloc;
+    for (uint64_t shelf = 0; shelf <= last_shelf; shelf++) {
+        uint64_t rows = std::min(SegmentedListShelfSize(layout, shelf), count - index);
+        uint64_t shelf_addr = LoadUnsigned(shelves.data() + shelf * layout.word_size, layout.word_size);
+        std::vector<uint8_t> chunk;
+        if (!ReadTargetMemory(process, shelf_addr, rows * layout.element_size, chunk)) return false;
+        memcpy(out.data() + index * layout.element_size, chunk.data(), chunk.size());
+        index += rows;
+    }
+    return true;
+}
+
+// seglist[index]: address and element type, resolved natively
+static bool ZigSegmentedListElement(SBValue list, uint64_t index, uint64_t& addr, SBType& type,
+                                    std::string& error) {
+    if (list.GetType().IsPointerType()) list = list.Dereference();
+    const SegmentedListLayout& layout = g_segmented_list_layouts.Get(list.GetType(), ClassifySegmentedList);
+    SegmentedListState state;
+    if (!IsZigSegmentedList(list) || !ReadSegmentedListState(list, layout, state)) {
+        error = "error: not a std.SegmentedList";
+        return false;
+    }
+    if (index >= state.len) {
+        error = "error: index " + std::to_string(index) + " out of bounds (len " + std::to_string(state.len) + ")";
+        return false;
+    }
+    if (!SegmentedListElementAddress(list, layout, state, index, addr)) {
+        error = "error: failed to read shelf pointer";
         return false;
     }
+    type = layout.element_type;
+    return true;
+}
 
-    // Get function pointers
-    auto GetCategory = (GetCategoryFn)(zdb::g_symbols.base + zdb::g_symbols.table.GetCategory);
-    auto Enable = (EnableFn)(zdb::g_symbols.base + zdb::g_symbols.table.Enable);
-    auto AddTypeSummary = (AddTypeSummaryFn)(zdb::g_symbols.base + zdb::g_symbols.table.AddTypeSummary);
+//===----------------------------------------------------------------------===//
+// Linked Lists
+//===----------------------------------------------------------------------===//
 
-    if (!zdb::g_symbols.table.GetCategory || !zdb::g_symbols.table.AddTypeSummary) {
-        fprintf(stderr, "[zdb] Missing required offsets\n");
+// std.SinglyLinkedList / DoublyLinkedList: { first: ?*Node, [last], ... }
+// with Node { [prev], next: ?*Node, [data: T] }. Current std lists are
+// intrusive and their nodes carry no data; older generic ones do.
+struct LinkedListLayout {
+    bool valid = false;
+    bool is_list = false;           // a list (has `first`), not a node
+    uint64_t first_offset = 0;
+    uint64_t next_offset = 0;
+    uint64_t word_size = 8;
+    bool has_data = false;
+    uint64_t data_offset = 0;
+    SBType data_type;
+    uint64_t data_size = 0;
+};
+
+// The node part of the layout; works from a list or a node type
+static void ClassifyLinkedListNode(SBType node, LinkedListLayout& layout) {
+    node = node.GetCanonicalType();
+    bool have_next = false;
+    for (uint32_t i = 0; i < node.GetNumberOfFields(); i++) {
+        SBTypeMember field = node.GetFieldAtIndex(i);
+        const char* name = field.GetName();
+        if (!name) continue;
+        if (strcmp(name, "next") == 0) {
+            layout.next_offset = field.GetOffsetInBytes();
+            layout.word_size = field.GetType().GetByteSize();
+            have_next = layout.word_size > 0 && layout.word_size <= 8;
+        } else if (strcmp(name, "data") == 0) {
+            layout.data_offset = field.GetOffsetInBytes();
+            layout.data_type = field.GetType();
+            layout.data_size = layout.data_type.GetByteSize();
+            layout.has_data = layout.data_size > 0;
+        }
+    }
+    layout.valid = have_next;
+}
+
+static LinkedListLayout ClassifyLinkedList(SBType type) {
+    LinkedListLayout layout;
+    type = type.GetCanonicalType();
+    for (uint32_t i = 0; i < type.GetNumberOfFields(); i++) {
+        SBTypeMember field = type.GetFieldAtIndex(i);
+        if (!field.GetName() || strcmp(field.GetName(), "first") != 0) continue;
+        // ?*Node is a plain pointer in debug info
+        SBType node = field.GetType().GetCanonicalType().GetPointeeType();
+        if (!node.IsValid()) return layout;
+        layout.is_list = true;
+        layout.first_offset = field.GetOffsetInBytes();
+        ClassifyLinkedListNode(node, layout);
+        return layout;
+    }
+    // Not a list: a node to start walking from
+    ClassifyLinkedListNode(type, layout);
+    return layout;
+}
+
+static TypeLayoutCache<LinkedListLayout> g_linked_list_layouts;
+
+static bool IsZigLinkedList(SBValue value) {
+    const char* name = value.GetTypeName();
+    if (!name) return false;
+    if (strncmp(name, "linked_list.", 12) == 0) name += 12;
+    return strncmp(name, "SinglyLinkedList", 16) == 0 || strncmp(name, "DoublyLinkedList", 16) == 0;
+}
+
+struct LinkedListWalk {
+    enum class Outcome { End, Cycle, Budget, ReadError };
+    Outcome outcome = Outcome::End;
+    uint64_t count = 0;              // distinct nodes visited
+    std::vector<uint64_t> nodes;     // addresses of the first `keep` nodes
+    uint64_t cycle_start = 0;        // index of the first node on the cycle
+    uint64_t cycle_length = 0;
+};
+
+static bool NextNode(SBProcess process, const LinkedListLayout& layout, uint64_t node, uint64_t& next) {
+    return g_read_cache.ReadPointer(process, node + layout.next_offset, layout.word_size, next);
+}
+
+// Follow `next` from `first` for at most `budget` nodes. Brent's algorithm
+// spots a cycle within about twice its length plus its offset, keeping
+// only two node addresses; every hop is served by the shared read cache.
+static void WalkLinkedList(SBProcess process, const LinkedListLayout& layout, uint64_t first,
+                           uint64_t budget, size_t keep, LinkedListWalk& walk) {
+    uint64_t tortoise = first, hare = first;
+    uint64_t power = 1, lambda = 0;
+    while (hare != 0) {
+        if (walk.count >= budget) {
+            walk.outcome = LinkedListWalk::Outcome::Budget;
+            return;
+        }
+        if (walk.nodes.size() < keep) walk.nodes.push_back(hare);
+        walk.count++;
+        if (!NextNode(process, layout, hare, hare)) {
+            walk.outcome = LinkedListWalk::Outcome::ReadError;
+            return;
+        }
+        lambda++;
+        if (hare == tortoise && hare != 0) break;
+        if (power == lambda) {
+            tortoise = hare;
+            power *= 2;
+            lambda = 0;
+        }
+    }
+    if (hare == 0) {
+        walk.outcome = LinkedListWalk::Outcome::End;
+        return;
+    }
+
+    // Cycle of length lambda: a pointer lambda hops ahead meets one from
+    // the head at the cycle's first node. All of these hops hit the cache.
+    walk.outcome = LinkedListWalk::Outcome::Cycle;
+    walk.cycle_length = lambda;
+    uint64_t a = first, b = first;
+    for (uint64_t i = 0; i < lambda; i++) {
+        if (!NextNode(process, layout, b, b)) return;
+    }
+    uint64_t mu = 0;
+    while (a != b && mu < budget) {
+        if (!NextNode(process, layout, a, a) || !NextNode(process, layout, b, b)) return;
+        mu++;
+    }
+    walk.cycle_start = mu;
+    walk.count = mu + lambda;
+    if (walk.nodes.size() > walk.count) walk.nodes.resize(walk.count);
+}
+
+// First node of a list value, or the node a node pointer points at
+static bool LinkedListStart(SBValue value, const LinkedListLayout*& layout, uint64_t& first) {
+    if (value.GetType().IsPointerType()) {
+        layout = &g_linked_list_layouts.Get(value.GetType().GetPointeeType(), ClassifyLinkedList);
+        if (layout->valid && !layout->is_list) {
+            first = value.GetValueAsUnsigned(0);
+            return true;
+        }
+        value = value.Dereference();
+    }
+    layout = &g_linked_list_layouts.Get(value.GetType(), ClassifyLinkedList);
+    if (!layout->valid) return false;
+    uint8_t word[8];
+    if (!ReadValueBytes(value, layout->first_offset, word, layout->word_size)) return false;
+    first = LoadUnsigned(word, layout->word_size);
+    return true;
+}
+
+// "1" for data nodes, "0x..." for intrusive ones
+static std::string LinkedListNodeText(SBProcess process, SBTarget target, const LinkedListLayout& layout,
+                                      uint64_t node) {
+    if (layout.has_data) {
+        std::vector<uint8_t> data(layout.data_size);
+        if (g_read_cache.Read(process, node + layout.data_offset, data.data(), data.size())) {
+            return ValueText(MakeValueFromBytes(target, "data", data.data(), data.size(), layout.data_type));
+        }
+    }
+    char buf[32];
+    snprintf(buf, sizeof(buf), "0x%llx", (unsigned long long)node);
+    return buf;
+}
+
+//===----------------------------------------------------------------------===//
+// Bit Sets
+//===----------------------------------------------------------------------===//
+
+// IntegerBitSet(N) is { mask: uN } and ArrayBitSet(M, N) is
+// { masks: [K]M }, both stored inline; DynamicBitSetUnmanaged is
+// { bit_length, masks: [*]M } pointing at heap words.
+enum class BitSetKind { Unknown, Inline, Dynamic };
+
+struct BitSetLayout {
+    BitSetKind kind = BitSetKind::Unknown;
+    uint64_t bit_length = 0;          // inline sets: from the type name
+    uint64_t masks_offset = 0;
+    uint64_t bit_length_offset = 0;   // dynamic sets
+    uint64_t word_size = 8;
+};
+
+// N from "bit_set.IntegerBitSet(N)" / "bit_set.ArrayBitSet(usize,N)"
+static uint64_t BitSetNameLength(const std::string& name) {
+    size_t close = name.rfind(')');
+    size_t start = name.find_last_of("(,", close);
+    if (close == std::string::npos || start == std::string::npos) return 0;
+    return strtoull(name.c_str() + start + 1, nullptr, 10);
+}
+
+static BitSetLayout ClassifyBitSet(SBType type) {
+    BitSetLayout layout;
+    std::string name = type.GetName() ? type.GetName() : "";
+    type = type.GetCanonicalType();
+    for (uint32_t i = 0; i < type.GetNumberOfFields(); i++) {
+        SBTypeMember field = type.GetFieldAtIndex(i);
+        const char* field_name = field.GetName();
+        if (!field_name) continue;
+        if (strcmp(field_name, "mask") == 0 || strcmp(field_name, "masks") == 0) {
+            layout.masks_offset = field.GetOffsetInBytes();
+            if (field.GetType().IsPointerType()) {
+                layout.kind = BitSetKind::Dynamic;
+                layout.word_size = field.GetType().GetByteSize();
+            } else {
+                layout.kind = BitSetKind::Inline;
+            }
+        } else if (strcmp(field_name, "bit_length") == 0) {
+            layout.bit_length_offset = field.GetOffsetInBytes();
+        }
+    }
+    if (layout.kind == BitSetKind::Inline) {
+        layout.bit_length = BitSetNameLength(name);
+        if (layout.bit_length == 0) layout.kind = BitSetKind::Unknown;
+    }
+    return layout;
+}
+
+static TypeLayoutCache<BitSetLayout> g_bit_set_layouts;
+
+// Managed DynamicBitSet wraps the unmanaged one
+static SBValue ResolveBitSet(SBValue value) {
+    if (value.GetType().IsPointerType()) value = value.Dereference();
+    SBValue unmanaged = value.GetChildMemberWithName("unmanaged");
+    return unmanaged.IsValid() ? unmanaged : value;
+}
+
+static bool IsZigBitSet(SBValue value) {
+    const char* name = ResolveBitSet(value).GetTypeName();
+    return name && strncmp(name, "bit_set.", 8) == 0;
+}
+
+// Bit length plus the mask bytes: inline sets come from the value's own
+// data, dynamic ones from one bulk read. Only the first `max_bits` bits are
+// read; nbits is always the full length.
+static bool ReadBitSet(SBValue value, uint64_t max_bits, uint64_t& nbits, std::vector<uint8_t>& bytes,
+                       std::string& error) {
+    value = ResolveBitSet(value);
+    const BitSetLayout& layout = g_bit_set_layouts.Get(value.GetType(), ClassifyBitSet);
+    nbits = 0;
+    if (layout.kind == BitSetKind::Unknown) {
+        error = "error: not a std bit set";
         return false;
     }
 
-    // Get/create "zig" category
-    SharedPtrLayout category_sp = {nullptr, nullptr};
-    GetCategory("zig", &category_sp, true);
+    uint64_t masks = 0;
+    if (layout.kind == BitSetKind::Inline) {
+        nbits = layout.bit_length;
+    } else {
+        uint8_t word[8];
+        if (!ReadValueBytes(value, layout.bit_length_offset, word, layout.word_size)) {
+            error = "error: failed to read bit set header";
+            return false;
+        }
+        nbits = LoadUnsigned(word, layout.word_size);
+        if (!ReadValueBytes(value, layout.masks_offset, word, layout.word_size)) {
+            error = "error: failed to read bit set header";
+            return false;
+        }
+        masks = LoadUnsigned(word, layout.word_size);
+    }
+    uint64_t scan_bits = std::min(nbits, max_bits);
 
-    if (!category_sp.ptr) {
-        fprintf(stderr, "[zdb] Failed to create 'zig' category\n");
+    // Whole 64-bit words, so the scans never read past the buffer
+    uint64_t used = (scan_bits + 7) / 8;
+    bytes.assign((scan_bits + 63) / 64 * 8, 0);
+    if (used == 0) return true;
+    if (layout.kind == BitSetKind::Inline) {
+        if (!ReadValueBytes(value, layout.masks_offset, bytes.data(), used)) {
+            error = "error: failed to read bit set masks";
+            return false;
+        }
+        return true;
+    }
+    std::vector<uint8_t> words;
+    if (!ReadTargetMemory(value.GetProcess(), masks, used, words)) {
+        error = "error: failed to read bit set masks";
         return false;
     }
+    memcpy(bytes.data(), words.data(), used);
+    return true;
+}
 
-    // Register formatters - LLDB uses LAST-MATCH, so register generic first, specific last
+//===----------------------------------------------------------------------===//
+// Ring Buffers
+//===----------------------------------------------------------------------===//
 
-    // 1. Catch-all for structs/enums (lowest priority)
-    // Matches: module.TypeName (e.g., test_types.Color, test_types.MyStruct)
-    RegisterFormatter(category_sp.ptr, AddTypeSummary, "^[a-z_][a-z0-9_]*\\.[A-Z][A-Za-z0-9_]*$", ZigStructSummary, "Zig struct/enum", true);
-    // Matches: standalone PascalCase types (e.g., Color, MyStruct)
-    RegisterFormatter(category_sp.ptr, AddTypeSummary, "^[A-Z][A-Za-z0-9_]*$", ZigStructSummary, "Zig type", true);
+// fifo.LinearFifo is { [allocator], buf: [N]T or []T, head, count } and
+// deque.Deque is { buffer: []T, head, len }. Logical element i lives at
+// buf[(head + i) % capacity], so the queue is at most two contiguous
+// segments: [head, capacity) and [0, rest).
+struct RingBufferLayout {
+    bool valid = false;
+    bool inline_buffer = false;     // [N]T stored in the value itself
+    uint64_t buffer_offset = 0;     // the array, or the slice's ptr (len follows)
+    uint64_t inline_capacity = 0;
+    uint64_t head_offset = 0;
+    uint64_t count_offset = 0;
+    uint64_t word_size = 8;
+    SBType element_type;
+    uint64_t element_size = 0;
+};
 
-    // 2. Generic Zig types
-    RegisterFormatter(category_sp.ptr, AddTypeSummary, "^\\[.*\\].*$", ZigArraySummary, "Zig array", true);
-    RegisterFormatter(category_sp.ptr, AddTypeSummary, "^\\[\\].*$", ZigSliceSummary, "Zig slice", true);
-    RegisterFormatter(category_sp.ptr, AddTypeSummary, "^\\?.*$", ZigOptionalSummary, "Zig optional", true);
-    RegisterFormatter(category_sp.ptr, AddTypeSummary, "^.*!.*$", ZigErrorUnionSummary, "Zig error union", true);
-    RegisterFormatter(category_sp.ptr, AddTypeSummary, "^union\\(.*\\)$", ZigTaggedUnionSummary, "Zig tagged union", true);
-    RegisterFormatter(category_sp.ptr, AddTypeSummary, "^\\*.*$", ZigPointerSummary, "Zig pointer", true);
-    RegisterFormatter(category_sp.ptr, AddTypeSummary, "^\\[\\*\\].*$", ZigPointerSummary, "Zig many pointer", true);
-    RegisterFormatter(category_sp.ptr, AddTypeSummary, "^\\[\\*:.*\\].*$", ZigPointerSummary, "Zig sentinel pointer", true);
+static RingBufferLayout ClassifyRingBuffer(SBType type) {
+    RingBufferLayout layout;
+    type = type.GetCanonicalType();
+    bool have_buffer = false, have_head = false, have_count = false;
+    for (uint32_t i = 0; i < type.GetNumberOfFields(); i++) {
+        SBTypeMember field = type.GetFieldAtIndex(i);
+        const char* name = field.GetName();
+        if (!name) continue;
+        if (strcmp(name, "buf") == 0 || strcmp(name, "buffer") == 0) {
+            SBType buffer = field.GetType().GetCanonicalType();
+            layout.buffer_offset = field.GetOffsetInBytes();
+            if (buffer.IsArrayType()) {
+                layout.inline_buffer = true;
+                layout.element_type = buffer.GetArrayElementType();
+                layout.element_size = layout.element_type.GetByteSize();
+                if (layout.element_size) layout.inline_capacity = buffer.GetByteSize() / layout.element_size;
+            } else if (buffer.GetNumberOfFields() >= 2) {
+                layout.element_type = buffer.GetFieldAtIndex(0).GetType().GetPointeeType();
+                layout.element_size = layout.element_type.GetByteSize();
+            }
+            have_buffer = layout.element_size > 0;
+        } else if (strcmp(name, "head") == 0) {
+            layout.head_offset = field.GetOffsetInBytes();
+            layout.word_size = field.GetType().GetByteSize();
+            have_head = true;
+        } else if (strcmp(name, "count") == 0 || strcmp(name, "len") == 0) {
+            layout.count_offset = field.GetOffsetInBytes();
+            have_count = true;
+        }
+    }
+    layout.valid = have_buffer && have_head && have_count && layout.word_size <= 8;
+    return layout;
+}
 
-    // 3. std library types (hide children - internal structure not useful)
-    RegisterFormatter(category_sp.ptr, AddTypeSummary, "^array_list\\..*$", ZigArrayListSummary, "Zig ArrayList", true, true);
-    RegisterFormatter(category_sp.ptr, AddTypeSummary, "^hash_map\\..*$", ZigHashMapSummary, "Zig HashMap", true, true);
-    RegisterFormatter(category_sp.ptr, AddTypeSummary, "^bounded_array\\..*$", ZigBoundedArraySummary, "Zig BoundedArray", true, true);
-    RegisterFormatter(category_sp.ptr, AddTypeSummary, "^multi_array_list\\..*$", ZigMultiArrayListSummary, "Zig MultiArrayList", true, true);
-    RegisterFormatter(category_sp.ptr, AddTypeSummary, "^segmented_list\\..*$", ZigSegmentedListSummary, "Zig SegmentedList", true, true);
+static TypeLayoutCache<RingBufferLayout> g_ring_buffer_layouts;
 
-    // 4. C strings (hide children - just show the string)
-    RegisterFormatter(category_sp.ptr, AddTypeSummary, "^\\[\\*:0\\]u8$", ZigCStringSummary, "Zig C string", true, true);
-    RegisterFormatter(category_sp.ptr, AddTypeSummary, "^\\[\\*:0\\]const u8$", ZigCStringSummary, "Zig const C string", true, true);
+struct RingBufferState {
+    uint64_t buffer = 0;      // heap buffer address (slice buffers)
+    uint64_t capacity = 0;
+    uint64_t head = 0;
+    uint64_t count = 0;
+};
 
-    // 5. Specific string types (hide children - just show the string)
-    RegisterFormatter(category_sp.ptr, AddTypeSummary, "^\\[\\]const u8$", ZigStringSummary, "Zig const string", true, true);
-    RegisterFormatter(category_sp.ptr, AddTypeSummary, "^\\[\\]u8$", ZigStringSummary, "Zig string", true, true);
+// All fields come from the value's own data
+static bool ReadRingBufferState(SBValue value, const RingBufferLayout& layout, RingBufferState& state) {
+    if (!layout.valid) return false;
+    uint8_t word[8];
+    if (!ReadValueBytes(value, layout.head_offset, word, layout.word_size)) return false;
+    state.head = LoadUnsigned(word, layout.word_size);
+    if (!ReadValueBytes(value, layout.count_offset, word, layout.word_size)) return false;
+    state.count = LoadUnsigned(word, layout.word_size);
+    if (layout.inline_buffer) {
+        state.capacity = layout.inline_capacity;
+    } else {
+        if (!ReadValueBytes(value, layout.buffer_offset, word, layout.word_size)) return false;
+        state.buffer = LoadUnsigned(word, layout.word_size);
+        if (!ReadValueBytes(value, layout.buffer_offset + layout.word_size, word, layout.word_size)) return false;
+        state.capacity = LoadUnsigned(word, layout.word_size);
+    }
+    // A corrupted header must not send us reading past the buffer
+    return state.capacity > 0 ? state.head < state.capacity && state.count <= state.capacity
+                              : state.count == 0;
+}
 
-    // 6. Synthetic children providers
-    // NOT SUPPORTED - LLDB's SBTypeSynthetic only has Python callbacks, no C callback API.
-    // The internal AddTypeSynthetic registers but lookup fails (unknown reason).
-    // Workaround: Use `p slice[n]` expression syntax (implemented in ZigExpressionCommand)
+// Logical elements [0, count) in queue order: one copy or read per segment
+static bool ReadRingBufferPrefix(SBValue value, const RingBufferLayout& layout, const RingBufferState& state,
+                                 uint64_t count, std::vector<uint8_t>& out) {
+    out.assign(count * layout.element_size, 0);
+    uint64_t first = std::min(count, state.capacity - state.head);
+    uint64_t segments[2][2] = {{state.head, first}, {0, count - first}};
+    uint64_t done = 0;
+    for (auto& segment : segments) {
+        if (segment[1] == 0) continue;
+        uint8_t* dst = out.data() + done * layout.element_size;
+        uint64_t size = segment[1] * layout.element_size;
+        if (layout.inline_buffer) {
+            if (!ReadValueBytes(value, layout.buffer_offset + segment[0] * layout.element_size, dst, size)) {
+                return false;
+            }
+        } else {
+            std::vector<uint8_t> bytes;
+            if (!ReadTargetMemory(value.GetProcess(), state.buffer + segment[0] * layout.element_size,
+                                  size, bytes)) {
+                return false;
+            }
+            memcpy(dst, bytes.data(), size);
+        }
+        done += segment[1];
+    }
+    return true;
+}
 
-    // Enable category
-    if (zdb::g_symbols.table.Enable) {
-        Enable(&category_sp, 0);
+//===----------------------------------------------------------------------===//
+// Numeric Keys
+//===----------------------------------------------------------------------===//
+
+// An integer or float inside an element (or the element itself) that
+// ordered containers can be sorted or searched by without running the
+// inferior's compare function
+struct NumericKey {
+    std::string name;                // "" for the element itself
+    uint64_t offset = 0;
+    uint64_t size = 0;
+    bool is_signed = false;
+    bool is_float = false;
+};
+
+static bool ClassifyNumericKey(SBType type, NumericKey& key) {
+    uint32_t flags = type.GetCanonicalType().GetTypeFlags();
+    key.size = type.GetByteSize();
+    key.is_float = (flags & eTypeIsFloat) != 0;
+    key.is_signed = (flags & eTypeIsSigned) != 0;
+    if (key.size == 0 || key.size > 8) return false;
+    if (key.is_float) return key.size == 4 || key.size == 8;
+    return (flags & eTypeIsInteger) != 0;
+}
+
+// Key bits mapped so that unsigned comparison matches numeric order
+static uint64_t NumericKeyAt(const NumericKey& key, const uint8_t* element) {
+    uint64_t bits = LoadUnsigned(element + key.offset, key.size);
+    uint64_t sign = 1ull << (key.size * 8 - 1);
+    if (key.is_float) {
+        if (key.size == 4) {
+            float f;
+            uint32_t raw = (uint32_t)bits;
+            memcpy(&f, &raw, sizeof(f));
+            double d = f;
+            memcpy(&bits, &d, sizeof(bits));
+        }
+        return (bits >> 63) ? ~bits : bits | (1ull << 63);
     }
+    if (key.is_signed) {
+        // Sign-extend, then flip the sign so negatives sort first
+        if (key.size < 8 && (bits & sign)) bits |= ~0ull << (key.size * 8);
+        return bits ^ (1ull << 63);
+    }
+    return bits;
+}
 
+// Parse command text into the same ordered form as NumericKeyAt
+static bool ParseNumericKey(const NumericKey& key, const std::string& text, uint64_t& out) {
+    char* end = nullptr;
+    uint8_t bytes[8] = {};
+    NumericKey parsed = key;
+    parsed.offset = 0;
+    if (key.is_float) {
+        double d = strtod(text.c_str(), &end);
+        parsed.size = 8;
+        memcpy(bytes, &d, sizeof(d));
+    } else if (key.is_signed) {
+        int64_t v = strtoll(text.c_str(), &end, 0);
+        parsed.size = 8;
+        memcpy(bytes, &v, sizeof(v));
+    } else {
+        uint64_t v = strtoull(text.c_str(), &end, 0);
+        parsed.size = 8;
+        memcpy(bytes, &v, sizeof(v));
+    }
+    if (text.empty() || !end || *end != '\0') return false;
+    out = NumericKeyAt(parsed, bytes);
     return true;
 }
 
 //===----------------------------------------------------------------------===//
-// Zig Expression Transformer
+// Priority Queues
 //===----------------------------------------------------------------------===//
 
-// Transform Zig expressions to C equivalents:
-//   slice[n]       -> slice.ptr[n]
-//   arraylist[n]   -> arraylist.items.ptr[n]
-//   optional.?     -> optional.data
-//   err catch val  -> (err.tag == 0 ? err.value : val)
+// PriorityQueue is { items: []T (len = count), cap, allocator, context }, a
+// binary heap with the highest priority at items[0]. PriorityDequeue is
+// { items: []T (len = capacity), len, allocator, context }, a min-max heap.
+//
+// The compare function is code in the inferior, so ordering is recovered
+// from data: a numeric key (the element, or one of its numeric fields)
+// that satisfies the heap invariant on every parent/child pair is taken
+// as the priority.
+struct PriorityQueueLayout {
+    bool valid = false;
+    bool dequeue = false;
+    uint64_t items_offset = 0;       // items.ptr; items.len follows
+    uint64_t count_offset = 0;       // PriorityQueue: cap, PriorityDequeue: len
+    uint64_t word_size = 8;
+    SBType element_type;
+    uint64_t element_size = 0;
+    std::vector<NumericKey> keys;  // candidates, in field order
+};
 
-namespace {
+static PriorityQueueLayout ClassifyPriorityQueue(SBType type) {
+    PriorityQueueLayout layout;
+    std::string name = type.GetName() ? type.GetName() : "";
+    layout.dequeue = name.find("PriorityDequeue(") != std::string::npos;
+    type = type.GetCanonicalType();
+    bool have_items = false, have_count = false;
+    for (uint32_t i = 0; i < type.GetNumberOfFields(); i++) {
+        SBTypeMember field = type.GetFieldAtIndex(i);
+        const char* field_name = field.GetName();
+        if (!field_name) continue;
+        if (strcmp(field_name, "items") == 0) {
+            SBType slice = field.GetType().GetCanonicalType();
+            if (slice.GetNumberOfFields() < 2) continue;
+            layout.items_offset = field.GetOffsetInBytes();
+            layout.word_size = slice.GetFieldAtIndex(0).GetType().GetByteSize();
+            layout.element_type = slice.GetFieldAtIndex(0).GetType().GetPointeeType();
+            layout.element_size = layout.element_type.GetByteSize();
+            have_items = layout.element_size > 0;
+        } else if (strcmp(field_name, layout.dequeue ? "len" : "cap") == 0) {
+            layout.count_offset = field.GetOffsetInBytes();
+            have_count = true;
+        }
+    }
+    layout.valid = have_items && have_count && layout.word_size <= 8;
+    if (!layout.valid) return layout;
 
-// Navigate a dot-separated path from a frame to get the SBValue
-SBValue GetValueAtPath(SBFrame frame, const std::string& path) {
-    if (path.empty()) return SBValue();
+    NumericKey key;
+    if (ClassifyNumericKey(layout.element_type, key)) {
+        layout.keys.push_back(key);
+        return layout;
+    }
+    SBType element = layout.element_type.GetCanonicalType();
+    for (uint32_t i = 0; i < element.GetNumberOfFields(); i++) {
+        SBTypeMember field = element.GetFieldAtIndex(i);
+        NumericKey field_key;
+        if (!field.GetName() || !ClassifyNumericKey(field.GetType(), field_key)) continue;
+        field_key.name = field.GetName();
+        field_key.offset = field.GetOffsetInBytes();
+        layout.keys.push_back(field_key);
+    }
+    return layout;
+}
 
-    size_t dot = path.find('.');
-    std::string root = (dot == std::string::npos) ? path : path.substr(0, dot);
-    SBValue val = frame.FindVariable(root.c_str());
+static TypeLayoutCache<PriorityQueueLayout> g_priority_queue_layouts;
 
-    if (!val.IsValid()) return SBValue();
-    if (dot == std::string::npos) return val;
+static bool IsZigPriorityQueue(SBValue value) {
+    const char* name = value.GetTypeName();
+    return name && (strncmp(name, "priority_queue.PriorityQueue(", 29) == 0 ||
+                    strncmp(name, "priority_dequeue.PriorityDequeue(", 33) == 0);
+}
 
-    // Navigate remaining path segments
-    size_t pos = dot + 1;
-    while (pos < path.length()) {
-        size_t next = path.find('.', pos);
-        std::string member = (next == std::string::npos)
-            ? path.substr(pos)
-            : path.substr(pos, next - pos);
-        val = val.GetChildMemberWithName(member.c_str());
-        if (!val.IsValid()) return SBValue();
-        pos = (next == std::string::npos) ? path.length() : next + 1;
+struct PriorityQueueState {
+    uint64_t items = 0;
+    uint64_t count = 0;
+    uint64_t capacity = 0;
+};
+
+static bool ReadPriorityQueueState(SBValue value, const PriorityQueueLayout& layout, PriorityQueueState& state) {
+    if (!layout.valid) return false;
+    uint8_t word[8];
+    if (!ReadValueBytes(value, layout.items_offset, word, layout.word_size)) return false;
+    state.items = LoadUnsigned(word, layout.word_size);
+    if (!ReadValueBytes(value, layout.items_offset + layout.word_size, word, layout.word_size)) return false;
+    uint64_t items_len = LoadUnsigned(word, layout.word_size);
+    if (!ReadValueBytes(value, layout.count_offset, word, layout.word_size)) return false;
+    uint64_t other = LoadUnsigned(word, layout.word_size);
+    state.count = layout.dequeue ? other : items_len;
+    state.capacity = layout.dequeue ? items_len : other;
+    return state.count <= state.capacity;
+}
+
+enum class HeapOrder { Unknown, Ascending, Descending };
+
+// The direction `key` orders a binary heap in, if it satisfies the heap
+// invariant everywhere. A key equal along every edge (a field that is
+// constant across the heap) orders nothing and yields Unknown.
+static HeapOrder BinaryHeapOrder(const NumericKey& key, const uint8_t* items, uint64_t count, uint64_t size) {
+    bool ascending = true, descending = true;
+    for (uint64_t child = 1; child < count && (ascending || descending); child++) {
+        uint64_t parent_key = NumericKeyAt(key, items + ((child - 1) / 2) * size);
+        uint64_t child_key = NumericKeyAt(key, items + child * size);
+        if (parent_key > child_key) ascending = false;
+        if (parent_key < child_key) descending = false;
+    }
+    if (ascending == descending) return HeapOrder::Unknown;
+    return ascending ? HeapOrder::Ascending : HeapOrder::Descending;
+}
+
+// Min-max heap: items[0] is the minimum under the compare function. As
+// above, the root must differ strictly from some element.
+static HeapOrder MinMaxHeapOrder(const NumericKey& key, const uint8_t* items, uint64_t count, uint64_t size) {
+    uint64_t root = NumericKeyAt(key, items);
+    bool ascending = true, descending = true;
+    for (uint64_t i = 1; i < count && (ascending || descending); i++) {
+        uint64_t k = NumericKeyAt(key, items + i * size);
+        if (k < root) ascending = false;
+        if (k > root) descending = false;
+    }
+    if (ascending == descending) return HeapOrder::Unknown;
+    return ascending ? HeapOrder::Ascending : HeapOrder::Descending;
+}
+
+// Indices of the first `k` elements in priority order. Binary heaps are
+// walked best-first from the root, touching O(k) nodes; min-max heaps are
+// partially sorted.
+static std::vector<uint64_t> HeapTopIndices(const PriorityQueueLayout& layout, const NumericKey& key,
+                                            HeapOrder order, const uint8_t* items, uint64_t count, uint64_t k) {
+    auto better = [&](uint64_t a, uint64_t b) {
+        uint64_t ka = NumericKeyAt(key, items + a * layout.element_size);
+        uint64_t kb = NumericKeyAt(key, items + b * layout.element_size);
+        return order == HeapOrder::Ascending ? ka < kb : ka > kb;
+    };
+    std::vector<uint64_t> top;
+    k = std::min(k, count);
+    if (layout.dequeue) {
+        std::vector<uint64_t> all(count);
+        for (uint64_t i = 0; i < count; i++) all[i] = i;
+        std::partial_sort(all.begin(), all.begin() + k, all.end(), better);
+        all.resize(k);
+        return all;
+    }
+    // Frontier ordered so the best candidate is at the back of the heap
+    std::vector<uint64_t> frontier;
+    auto worse = [&](uint64_t a, uint64_t b) { return better(b, a); };
+    if (count > 0) frontier.push_back(0);
+    while (top.size() < k && !frontier.empty()) {
+        std::pop_heap(frontier.begin(), frontier.end(), worse);
+        uint64_t index = frontier.back();
+        frontier.pop_back();
+        top.push_back(index);
+        for (uint64_t child = 2 * index + 1; child <= 2 * index + 2 && child < count; child++) {
+            frontier.push_back(child);
+            std::push_heap(frontier.begin(), frontier.end(), worse);
+        }
+    }
+    return top;
+}
+
+//===----------------------------------------------------------------------===//
+// Treaps
+//===----------------------------------------------------------------------===//
+
+// std.Treap(Key, compareFn) is { root: ?*Node, prng } with
+// Node { key, priority, parent, children: [2]?*Node }. Walks keep an
+// explicit stack (no recursion into the debugger) and read each node once
+// through the shared read cache, which also batches siblings allocated
+// close together.
+struct TreapLayout {
+    bool valid = false;
+    uint64_t root_offset = 0;
+    uint64_t key_offset = 0;
+    uint64_t children_offset = 0;
+    uint64_t word_size = 8;
+    uint64_t node_size = 0;
+    SBType key_type;
+    uint64_t key_size = 0;
+    bool numeric = false;            // --from seeks need an ordered key
+    NumericKey key;
+};
+
+static TreapLayout ClassifyTreap(SBType type) {
+    TreapLayout layout;
+    type = type.GetCanonicalType();
+    SBType node;
+    for (uint32_t i = 0; i < type.GetNumberOfFields(); i++) {
+        SBTypeMember field = type.GetFieldAtIndex(i);
+        if (field.GetName() && strcmp(field.GetName(), "root") == 0) {
+            layout.root_offset = field.GetOffsetInBytes();
+            layout.word_size = field.GetType().GetByteSize();
+            node = field.GetType().GetCanonicalType().GetPointeeType().GetCanonicalType();
+        }
+    }
+    if (!node.IsValid() || layout.word_size == 0 || layout.word_size > 8) return layout;
+
+    bool have_key = false, have_children = false;
+    for (uint32_t i = 0; i < node.GetNumberOfFields(); i++) {
+        SBTypeMember field = node.GetFieldAtIndex(i);
+        const char* name = field.GetName();
+        if (!name) continue;
+        if (strcmp(name, "key") == 0) {
+            layout.key_offset = field.GetOffsetInBytes();
+            layout.key_type = field.GetType();
+            layout.key_size = layout.key_type.GetByteSize();
+            layout.numeric = ClassifyNumericKey(layout.key_type, layout.key);
+            layout.key.offset = layout.key_offset;
+            have_key = true;
+        } else if (strcmp(name, "children") == 0) {
+            layout.children_offset = field.GetOffsetInBytes();
+            have_children = true;
+        }
+    }
+    layout.node_size = node.GetByteSize();
+    layout.valid = have_key && have_children && layout.node_size > 0;
+    return layout;
+}
+
+static TypeLayoutCache<TreapLayout> g_treap_layouts;
+
+static bool IsZigTreap(SBValue value) {
+    const char* name = value.GetTypeName();
+    if (!name || strncmp(name, "treap.Treap(", 12) != 0) return false;
+    size_t len = strlen(name);
+    return name[len - 1] == ')';
+}
+
+struct TreapNode {
+    uint64_t addr = 0;
+    uint64_t depth = 1;                  // root is depth 1
+    std::vector<uint8_t> bytes;
+    uint64_t Child(const TreapLayout& layout, int side) const {
+        return LoadUnsigned(bytes.data() + layout.children_offset + side * layout.word_size, layout.word_size);
+    }
+};
+
+static bool ReadTreapNode(SBProcess process, const TreapLayout& layout, uint64_t addr, uint64_t depth,
+                          TreapNode& node) {
+    node.addr = addr;
+    node.depth = depth;
+    node.bytes.resize(layout.node_size);
+    return g_read_cache.Read(process, addr, node.bytes.data(), node.bytes.size());
+}
+
+struct TreapStats {
+    uint64_t size = 0;
+    uint64_t depth = 0;
+    bool complete = true;        // false when the budget ran out or a read failed
+};
+
+// Node count and height, visiting at most `budget` nodes
+static TreapStats MeasureTreap(SBProcess process, const TreapLayout& layout, uint64_t root, uint64_t budget) {
+    TreapStats stats;
+    std::vector<std::pair<uint64_t, uint64_t>> stack;   // (node, depth)
+    if (root) stack.push_back({root, 1});
+    TreapNode node;
+    while (!stack.empty()) {
+        if (stats.size >= budget) {
+            stats.complete = false;
+            break;
+        }
+        auto [addr, depth] = stack.back();
+        stack.pop_back();
+        if (!ReadTreapNode(process, layout, addr, depth, node)) {
+            stats.complete = false;
+            break;
+        }
+        stats.size++;
+        stats.depth = std::max(stats.depth, depth);
+        for (int side = 1; side >= 0; side--) {
+            uint64_t child = node.Child(layout, side);
+            if (child) stack.push_back({child, depth + 1});
+        }
+    }
+    return stats;
+}
+
+// In-order walk: up to `count` nodes with key >= *from (all when from is
+// null), visiting at most `budget` nodes. `more` reports whether nodes
+// remain after the last one returned.
+static bool WalkTreapInOrder(SBProcess process, const TreapLayout& layout, uint64_t root, const uint64_t* from,
+                             uint64_t count, uint64_t budget, std::vector<TreapNode>& out, bool& more) {
+    std::vector<TreapNode> stack;
+    uint64_t visited = 0;
+    more = false;
+
+    // Push the left spine of `addr`, skipping subtrees below `from`
+    auto descend = [&](uint64_t addr, uint64_t depth) -> bool {
+        while (addr) {
+            TreapNode node;
+            if (visited++ >= budget || !ReadTreapNode(process, layout, addr, depth, node)) return false;
+            if (from && NumericKeyAt(layout.key, node.bytes.data()) < *from) {
+                addr = node.Child(layout, 1);
+            } else {
+                addr = node.Child(layout, 0);
+                stack.push_back(std::move(node));
+            }
+            depth++;
+        }
+        return true;
+    };
+
+    if (!descend(root, 1)) return false;
+    while (!stack.empty()) {
+        if (out.size() >= count) {
+            more = true;
+            return true;
+        }
+        TreapNode node = std::move(stack.back());
+        stack.pop_back();
+        uint64_t right = node.Child(layout, 1);
+        uint64_t depth = node.depth + 1;
+        out.push_back(std::move(node));
+        // Right subtrees hold larger keys; the seek bound no longer prunes
+        if (!descend(right, depth)) return false;
+    }
+    return true;
+}
+
+//===----------------------------------------------------------------------===//
+// Enum Containers
+//===----------------------------------------------------------------------===//
+
+// Tag names of an enum in EnumIndexer order (fields sorted by value), so
+// name i labels slot i of EnumArray/EnumMap/EnumSet storage
+struct EnumTagTable {
+    std::vector<std::string> names;
+};
+
+static EnumTagTable ClassifyEnumTags(SBType type) {
+    EnumTagTable table;
+    SBTypeEnumMemberList members = type.GetCanonicalType().GetEnumMembers();
+    std::vector<std::pair<int64_t, std::string>> fields;
+    for (uint32_t i = 0; i < members.GetSize(); i++) {
+        SBTypeEnumMember member = members.GetTypeEnumMemberAtIndex(i);
+        fields.push_back({member.GetValueAsSigned(), member.GetName() ? member.GetName() : "?"});
+    }
+    std::stable_sort(fields.begin(), fields.end(),
+        [](const auto& a, const auto& b) { return a.first < b.first; });
+    for (auto& field : fields) table.names.push_back(std::move(field.second));
+    return table;
+}
+
+static TypeLayoutCache<EnumTagTable> g_enum_tag_tables;
+
+// EnumArray(E, V) is { values: [n]V }, EnumSet(E) is { bits: StaticBitSet(n) }
+// and EnumMap(E, V) is both; all storage is inline in the value.
+struct EnumContainerLayout {
+    bool valid = false;
+    bool has_values = false;
+    bool has_bits = false;
+    uint64_t count = 0;
+    uint64_t values_offset = 0;
+    SBType value_type;
+    uint64_t value_size = 0;
+    uint64_t bits_offset = 0;
+    std::vector<std::string> names;   // from the key enum's tag table
+};
+
+static EnumContainerLayout ClassifyEnumContainer(SBValue value) {
+    EnumContainerLayout layout;
+    SBType type = value.GetType().GetCanonicalType();
+    for (uint32_t i = 0; i < type.GetNumberOfFields(); i++) {
+        SBTypeMember field = type.GetFieldAtIndex(i);
+        const char* name = field.GetName();
+        if (!name) continue;
+        if (strcmp(name, "values") == 0 && field.GetType().GetCanonicalType().IsArrayType()) {
+            SBType array = field.GetType().GetCanonicalType();
+            layout.values_offset = field.GetOffsetInBytes();
+            layout.value_type = array.GetArrayElementType();
+            layout.value_size = layout.value_type.GetByteSize();
+            layout.count = layout.value_size ? array.GetByteSize() / layout.value_size : 0;
+            layout.has_values = true;
+        } else if (strcmp(name, "bits") == 0) {
+            // IntegerBitSet/ArrayBitSet: the masks are the struct's only field
+            layout.bits_offset = field.GetOffsetInBytes();
+            layout.has_bits = true;
+        }
+    }
+
+    std::string key_name = TypeNameArgument(value.GetTypeName() ? value.GetTypeName() : "", 0);
+    SBType key = key_name.empty() ? SBType() : value.GetTarget().FindFirstType(key_name.c_str());
+    if (key.IsValid()) {
+        layout.names = g_enum_tag_tables.Get(key, ClassifyEnumTags).names;
+        if (!layout.has_values) layout.count = layout.names.size();
+    }
+    layout.valid = (layout.has_values || layout.has_bits) && layout.count > 0;
+    return layout;
+}
+
+static TypeLayoutCache<EnumContainerLayout> g_enum_container_layouts;
+
+//===----------------------------------------------------------------------===//
+// JSON Values
+//===----------------------------------------------------------------------===//
+
+// Offset of a dotted field path ("unmanaged.entries") within `type`
+static bool FieldPathOffset(SBType type, const std::string& path, uint64_t& offset, SBType& field_type) {
+    offset = 0;
+    field_type = type;
+    size_t start = 0;
+    while (start <= path.size()) {
+        size_t dot = path.find('.', start);
+        std::string name = path.substr(start, dot == std::string::npos ? std::string::npos : dot - start);
+        SBType current = field_type.GetCanonicalType();
+        bool found = false;
+        for (uint32_t i = 0; i < current.GetNumberOfFields() && !found; i++) {
+            SBTypeMember field = current.GetFieldAtIndex(i);
+            if (field.GetName() && name == field.GetName()) {
+                offset += field.GetOffsetInBytes();
+                field_type = field.GetType();
+                found = true;
+            }
+        }
+        if (!found) return false;
+        if (dot == std::string::npos) break;
+        start = dot + 1;
+    }
+    return true;
+}
+
+// std.json.Value is union(enum) { null, bool, integer: i64, float: f64,
+// number_string: []const u8, string: []const u8, array: Array,
+// object: ObjectMap }, laid out as { tag, payload }. Array is an ArrayList
+// of Value; ObjectMap is a string ArrayHashMap whose entries
+// MultiArrayList holds key and value columns.
+enum class JsonKind { Null, Bool, Integer, Float, NumberString, String, Array, Object, Count };
+
+struct JsonLayout {
+    bool valid = false;
+    uint64_t value_size = 0;
+    uint64_t tag_offset = 0;
+    uint64_t tag_size = 0;
+    uint64_t payload_offset = 0;
+    int64_t tags[(int)JsonKind::Count];
+    uint64_t word_size = 8;
+    std::string array_type;
+    std::string object_type;
+    uint64_t array_items_offset = 0;        // within the Array payload
+    uint64_t object_entries_offset = 0;     // within the ObjectMap payload
+    uint64_t entries_bytes_offset = 0;      // within the entries MultiArrayList
+    uint64_t entries_len_offset = 0;
+    uint64_t entries_capacity_offset = 0;
+    MultiArrayListLayout entries;
+    int key_column = -1;
+    int value_column = -1;
+};
+
+static JsonLayout ClassifyJsonValue(TargetType source) {
+    JsonLayout layout;
+    for (int64_t& tag : layout.tags) tag = -1;
+    SBType type = source.type.GetCanonicalType();
+    layout.value_size = type.GetByteSize();
+    layout.word_size = source.target.GetAddressByteSize();
+
+    SBType tag_type, payload_type;
+    if (!FieldPathOffset(type, "tag", layout.tag_offset, tag_type) ||
+        !FieldPathOffset(type, "payload", layout.payload_offset, payload_type)) {
+        return layout;
+    }
+    layout.tag_size = tag_type.GetByteSize();
+    static const char* const kTagNames[] = {
+        "null", "bool", "integer", "float", "number_string", "string", "array", "object"};
+    SBTypeEnumMemberList members = tag_type.GetCanonicalType().GetEnumMembers();
+    for (uint32_t i = 0; i < members.GetSize(); i++) {
+        SBTypeEnumMember member = members.GetTypeEnumMemberAtIndex(i);
+        for (int k = 0; k < (int)JsonKind::Count; k++) {
+            if (member.GetName() && strcmp(member.GetName(), kTagNames[k]) == 0) {
+                layout.tags[k] = member.GetValueAsSigned();
+            }
+        }
+    }
+
+    uint64_t offset = 0;
+    SBType array_type, object_type, items_type, entries_type, unused;
+    if (!FieldPathOffset(payload_type, "array", offset, array_type) ||
+        !FieldPathOffset(array_type, "items", layout.array_items_offset, items_type) ||
+        !FieldPathOffset(payload_type, "object", offset, object_type)) {
+        return layout;
+    }
+    // Managed maps wrap the unmanaged one
+    if (!FieldPathOffset(object_type, "unmanaged.entries", layout.object_entries_offset, entries_type) &&
+        !FieldPathOffset(object_type, "entries", layout.object_entries_offset, entries_type)) {
+        return layout;
+    }
+    if (!FieldPathOffset(entries_type, "bytes", layout.entries_bytes_offset, unused) ||
+        !FieldPathOffset(entries_type, "len", layout.entries_len_offset, unused) ||
+        !FieldPathOffset(entries_type, "capacity", layout.entries_capacity_offset, unused)) {
+        return layout;
+    }
+    layout.array_type = array_type.GetName() ? array_type.GetName() : "";
+    layout.object_type = object_type.GetName() ? object_type.GetName() : "";
+    layout.entries = ClassifyMultiArrayListType(source.target, entries_type.GetName());
+    for (size_t i = 0; i < layout.entries.columns.size(); i++) {
+        if (layout.entries.columns[i].name == "key") layout.key_column = (int)i;
+        if (layout.entries.columns[i].name == "value") layout.value_column = (int)i;
+    }
+    layout.valid = layout.key_column >= 0 && layout.value_column >= 0 && layout.tag_size > 0 &&
+                   layout.tag_size <= 8 && layout.value_size > 0;
+    return layout;
+}
+
+static TypeLayoutCache<JsonLayout> g_json_layouts;
+
+// Serializes a Value tree to compact JSON from target memory. Arrays and
+// object columns are fetched with one read each; string bytes go through
+// the shared read cache, so strings allocated together share reads. Output
+// stops at max_bytes, and anything cut (depth, length) is shown as "...".
+class JsonWriter {
+public:
+    JsonWriter(SBProcess process, const JsonLayout& layout, uint64_t max_depth, uint64_t max_bytes)
+        : m_process(process), m_layout(layout), m_max_depth(max_depth), m_max_bytes(max_bytes) {}
+
+    // `value` holds one Value's bytes
+    void WriteValue(const uint8_t* value, uint64_t depth) {
+        if (Full()) return;
+        int64_t tag = (int64_t)LoadUnsigned(value + m_layout.tag_offset, m_layout.tag_size);
+        const uint8_t* payload = value + m_layout.payload_offset;
+        JsonKind kind = JsonKind::Count;
+        for (int k = 0; k < (int)JsonKind::Count; k++) {
+            if (m_layout.tags[k] == tag) kind = (JsonKind)k;
+        }
+        WritePayload(kind, payload, depth);
+    }
+
+    void WritePayload(JsonKind kind, const uint8_t* payload, uint64_t depth) {
+        char buf[64];
+        switch (kind) {
+        case JsonKind::Null:
+            Append("null");
+            break;
+        case JsonKind::Bool:
+            Append(payload[0] ? "true" : "false");
+            break;
+        case JsonKind::Integer: {
+            int64_t v;
+            memcpy(&v, payload, sizeof(v));
+            snprintf(buf, sizeof(buf), "%lld", (long long)v);
+            Append(buf);
+            break;
+        }
+        case JsonKind::Float: {
+            double v;
+            memcpy(&v, payload, sizeof(v));
+            FormatDouble(v, buf, sizeof(buf));
+            Append(buf);
+            break;
+        }
+        case JsonKind::NumberString:
+            WriteString(payload, false);
+            break;
+        case JsonKind::String:
+            WriteString(payload, true);
+            break;
+        case JsonKind::Array:
+            WriteArray(payload, depth);
+            break;
+        case JsonKind::Object:
+            WriteObject(payload, depth);
+            break;
+        case JsonKind::Count:
+            Append("?");
+            break;
+        }
+    }
+
+    const std::string& Output() const { return m_out; }
+
+private:
+    bool Full() const { return m_cut; }
+
+    // Append text, or mark the cut when it no longer fits. The marker
+    // counts against the budget: output is backed off (never into a UTF-8
+    // sequence) until it fits too.
+    bool Append(const std::string& text) {
+        static const char kCut[] = "...";
+        if (m_cut) return false;
+        if (m_out.size() + text.size() > m_max_bytes) {
+            size_t keep = m_max_bytes > sizeof(kCut) - 1 ? m_max_bytes - (sizeof(kCut) - 1) : 0;
+            if (m_out.size() > keep) {
+                m_out.resize(keep);
+                while (!m_out.empty() && ((unsigned char)m_out.back() & 0xC0) == 0x80) m_out.pop_back();
+                if (!m_out.empty() && (unsigned char)m_out.back() >= 0xC0) m_out.pop_back();
+            }
+            m_out += kCut;
+            m_cut = true;
+            return false;
+        }
+        m_out += text;
+        return true;
+    }
+
+    uint64_t Word(const uint8_t* bytes) const { return LoadUnsigned(bytes, m_layout.word_size); }
+
+    uint64_t Remaining() const { return m_max_bytes > m_out.size() ? m_max_bytes - m_out.size() : 0; }
+
+    static void FormatDouble(double v, char* buf, size_t size) {
+        // JSON has no NaN or infinity literals; quote them so the output
+        // still parses
+        if (std::isnan(v)) {
+            snprintf(buf, size, "\"NaN\"");
+            return;
+        }
+        if (std::isinf(v)) {
+            snprintf(buf, size, v < 0 ? "\"-Infinity\"" : "\"Infinity\"");
+            return;
+        }
+        // Shortest precision that round-trips
+        for (int precision = 1; precision <= 17; precision++) {
+            snprintf(buf, size, "%.*g", precision, v);
+            if (strtod(buf, nullptr) == v) return;
+        }
+    }
+
+    // { ptr, len } slice; quoted strings are JSON-escaped
+    void WriteString(const uint8_t* slice, bool quoted) {
+        uint64_t ptr = Word(slice);
+        uint64_t len = Word(slice + m_layout.word_size);
+        // Read no more than could still be printed
+        uint64_t take = std::min(len, Remaining() + 1);
+        std::string bytes(take, '\0');
+        if (take > 0 && !g_read_cache.Read(m_process, ptr, &bytes[0], take)) {
+            Append("<unreadable>");
+            return;
+        }
+        if (!quoted) {
+            Append(bytes);
+            return;
+        }
+        std::string out = "\"";
+        for (unsigned char c : bytes) {
+            switch (c) {
+            case '"': out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                if (c < 0x20) {
+                    char esc[8];
+                    snprintf(esc, sizeof(esc), "\\u%04x", c);
+                    out += esc;
+                } else {
+                    out += (char)c;
+                }
+            }
+        }
+        out += "\"";
+        Append(out);
+    }
+
+    // Every element costs at least one output byte, so no more than the
+    // remaining budget is ever read
+    void WriteArray(const uint8_t* array, uint64_t depth) {
+        uint64_t ptr = Word(array + m_layout.array_items_offset);
+        uint64_t len = Word(array + m_layout.array_items_offset + m_layout.word_size);
+        if (len == 0) {
+            Append("[]");
+            return;
+        }
+        if (depth >= m_max_depth) {
+            Append("[...]");
+            return;
+        }
+        uint64_t take = std::min(len, Remaining());
+        std::vector<uint8_t> items;
+        if (!ReadTargetMemory(m_process, ptr, take * m_layout.value_size, items)) {
+            Append("[<unreadable>]");
+            return;
+        }
+        if (!Append("[")) return;
+        for (uint64_t i = 0; i < take && !m_cut; i++) {
+            if (i > 0 && !Append(",")) return;
+            WriteValue(items.data() + i * m_layout.value_size, depth + 1);
+        }
+        if (take < len) {
+            Append(",...");
+            return;
+        }
+        Append("]");
+    }
+
+    void WriteObject(const uint8_t* object, uint64_t depth) {
+        const uint8_t* entries = object + m_layout.object_entries_offset;
+        MultiArrayListState state;
+        state.bytes = Word(entries + m_layout.entries_bytes_offset);
+        state.len = Word(entries + m_layout.entries_len_offset);
+        state.capacity = Word(entries + m_layout.entries_capacity_offset);
+        if (state.len == 0) {
+            Append("{}");
+            return;
+        }
+        if (depth >= m_max_depth) {
+            Append("{...}");
+            return;
+        }
+        const MultiArrayListColumn& key_column = m_layout.entries.columns[m_layout.key_column];
+        const MultiArrayListColumn& value_column = m_layout.entries.columns[m_layout.value_column];
+        uint64_t take = std::min(state.len, Remaining());
+        std::vector<uint8_t> keys, values;
+        if (!ReadMultiArrayListColumn(m_process, state, key_column, 0, take, keys) ||
+            !ReadMultiArrayListColumn(m_process, state, value_column, 0, take, values)) {
+            Append("{<unreadable>}");
+            return;
+        }
+        if (!Append("{")) return;
+        for (uint64_t i = 0; i < take && !m_cut; i++) {
+            if (i > 0 && !Append(",")) return;
+            WriteString(keys.data() + i * key_column.size, true);
+            if (!Append(":")) return;
+            WriteValue(values.data() + i * value_column.size, depth + 1);
+        }
+        if (take < state.len) {
+            Append(",...");
+            return;
+        }
+        Append("}");
+    }
+
+    SBProcess m_process;
+    const JsonLayout& m_layout;
+    uint64_t m_max_depth;
+    uint64_t m_max_bytes;
+    std::string m_out;
+    bool m_cut = false;
+};
+
+// Resolve a json.Value, ObjectMap or Array value and serialize it
+static bool ZigJsonSerialize(SBValue value, uint64_t max_depth, uint64_t max_bytes, std::string& out,
+                             std::string& error) {
+    if (value.GetType().IsPointerType()) value = value.Dereference();
+    const char* name = value.GetTypeName();
+    std::string type_name = name ? name : "";
+
+    TargetType json_type{value.GetTarget(), value.GetType()};
+    if (type_name != "json.dynamic.Value") {
+        json_type.type = json_type.target.FindFirstType("json.dynamic.Value");
+        if (!json_type.type.IsValid()) {
+            error = "error: std.json.Value not found in debug info";
+            return false;
+        }
+    }
+    const JsonLayout& layout = g_json_layouts.Get(json_type, ClassifyJsonValue);
+    if (!layout.valid) {
+        error = "error: unrecognized std.json.Value layout";
+        return false;
+    }
+
+    JsonKind root = JsonKind::Count;
+    if (type_name == "json.dynamic.Value") {
+        root = JsonKind::Null;      // any kind; decided from the tag
+    } else if (type_name == layout.array_type) {
+        root = JsonKind::Array;
+    } else if (type_name == layout.object_type) {
+        root = JsonKind::Object;
+    } else {
+        error = "error: not a std.json.Value, ObjectMap or Array";
+        return false;
+    }
+
+    std::vector<uint8_t> bytes(value.GetByteSize());
+    if (bytes.empty() || !ReadValueBytes(value, 0, bytes.data(), bytes.size())) {
+        error = "error: failed to read value";
+        return false;
+    }
+    JsonWriter writer(value.GetProcess(), layout, max_depth, max_bytes);
+    if (root == JsonKind::Null) {
+        writer.WriteValue(bytes.data(), 0);
+    } else {
+        writer.WritePayload(root, bytes.data(), 0);
+    }
+    out = writer.Output();
+    return true;
+}
+
+//===----------------------------------------------------------------------===//
+// Big Integers
+//===----------------------------------------------------------------------===//
+
+// std.math.big.int comes in three shapes over the same little-endian usize
+// limbs: Managed { allocator, limbs, metadata } keeps the sign in the top
+// bit of metadata and the used length below it, Mutable { limbs, len,
+// positive } and Const { limbs, positive } use every limb of the slice.
+enum class BigIntKind { Managed, Mutable, Const };
+
+struct BigIntLayout {
+    bool valid = false;
+    BigIntKind kind = BigIntKind::Const;
+    uint64_t limbs_ptr_offset = 0;
+    uint64_t limbs_len_offset = 0;
+    uint64_t limb_size = 8;
+    uint64_t word_size = 8;
+    uint64_t metadata_offset = 0;   // Managed
+    uint64_t len_offset = 0;        // Mutable
+    uint64_t positive_offset = 0;   // Mutable, Const
+};
+
+static BigIntLayout ClassifyBigInt(SBType type) {
+    BigIntLayout layout;
+    type = type.GetCanonicalType();
+    SBType ptr_type, field_type;
+    if (!FieldPathOffset(type, "limbs.ptr", layout.limbs_ptr_offset, ptr_type) ||
+        !FieldPathOffset(type, "limbs.len", layout.limbs_len_offset, field_type)) {
+        return layout;
+    }
+    layout.word_size = field_type.GetByteSize();
+    layout.limb_size = ptr_type.GetPointeeType().GetByteSize();
+    if (FieldPathOffset(type, "metadata", layout.metadata_offset, field_type)) {
+        layout.kind = BigIntKind::Managed;
+    } else if (!FieldPathOffset(type, "positive", layout.positive_offset, field_type)) {
+        return layout;
+    } else if (FieldPathOffset(type, "len", layout.len_offset, field_type)) {
+        layout.kind = BigIntKind::Mutable;
+    } else {
+        layout.kind = BigIntKind::Const;
+    }
+    layout.valid = (layout.limb_size == 4 || layout.limb_size == 8) &&
+                   (layout.word_size == 4 || layout.word_size == 8);
+    return layout;
+}
+
+static TypeLayoutCache<BigIntLayout> g_big_int_layouts;
+
+static bool IsZigBigInt(SBValue value) {
+    const char* name = value.GetTypeName();
+    return name && strncmp(name, "math.big.int.", 13) == 0 &&
+           g_big_int_layouts.Get(value.GetType(), ClassifyBigInt).valid;
+}
+
+struct BigIntHeader {
+    uint64_t limbs_addr = 0;
+    uint64_t len = 0;        // limbs in use
+    bool negative = false;
+};
+
+static bool ReadBigIntHeader(SBValue value, const BigIntLayout& layout, BigIntHeader& header) {
+    uint8_t buf[8];
+    uint64_t capacity;
+    if (!ReadValueBytes(value, layout.limbs_ptr_offset, buf, layout.word_size)) return false;
+    header.limbs_addr = LoadUnsigned(buf, layout.word_size);
+    if (!ReadValueBytes(value, layout.limbs_len_offset, buf, layout.word_size)) return false;
+    capacity = LoadUnsigned(buf, layout.word_size);
+    header.len = capacity;
+    if (layout.kind == BigIntKind::Managed) {
+        if (!ReadValueBytes(value, layout.metadata_offset, buf, layout.word_size)) return false;
+        uint64_t metadata = LoadUnsigned(buf, layout.word_size);
+        uint64_t sign_bit = 1ull << (8 * layout.word_size - 1);
+        header.negative = (metadata & sign_bit) != 0;
+        header.len = metadata & ~sign_bit;
+    } else {
+        if (!ReadValueBytes(value, layout.positive_offset, buf, 1)) return false;
+        header.negative = buf[0] == 0;
+        if (layout.kind == BigIntKind::Mutable) {
+            if (!ReadValueBytes(value, layout.len_offset, buf, layout.word_size)) return false;
+            header.len = LoadUnsigned(buf, layout.word_size);
+        }
+    }
+    return header.len <= capacity && (header.len == 0 || header.limbs_addr != 0);
+}
+
+// Limbs [first, first + count) widened to 64-bit limbs, with one read
+static bool ReadBigIntLimbs(SBProcess process, const BigIntLayout& layout, const BigIntHeader& header,
+                            uint64_t first, uint64_t count, zdb::Limbs& out) {
+    std::vector<uint8_t> bytes;
+    if (!ReadTargetMemory(process, header.limbs_addr + first * layout.limb_size,
+                          count * layout.limb_size, bytes)) {
+        return false;
+    }
+    size_t per = 8 / layout.limb_size;
+    out.assign((count + per - 1) / per, 0);
+    for (uint64_t i = 0; i < count; i++) {
+        out[i / per] |= LoadUnsigned(&bytes[i * layout.limb_size], layout.limb_size) << (64 / per * (i % per));
+    }
+    zdb::NormalizeLimbs(out);
+    return true;
+}
+
+static zdb::DecimalConverter g_decimal_converter;
+
+// First and last `digits` digits of a long decimal, with the total between
+static std::string ElideDigits(const std::string& text, uint64_t digits) {
+    if (digits == 0 || text.size() <= 2 * digits + 1) return text;
+    char middle[64];
+    snprintf(middle, sizeof(middle), "...(%zu digits)...", text.size());
+    return text.substr(0, digits) + middle + text.substr(text.size() - digits);
+}
+
+//===----------------------------------------------------------------------===//
+// Allocators
+//===----------------------------------------------------------------------===//
+
+// ArenaAllocator { child_allocator, state: { buffer_list, end_index } }.
+// Each buffer starts with a BufNode holding its total length (`data`) and
+// the list link; the newest buffer is first and end_index counts bytes used
+// past its BufNode. Older arenas use SinglyLinkedList(usize), whose node is
+// the BufNode; current ones link BufNode.node intrusively.
+struct ArenaLayout {
+    bool valid = false;
+    uint64_t first_offset = 0;       // within the value holding the arena
+    uint64_t end_index_offset = 0;
+    uint64_t word_size = 8;
+    LinkedListLayout buffers;        // `next` within the linked node
+    int64_t data_offset = 0;         // buffer length, relative to the linked node
+    uint64_t header_size = 0;        // bytes of each buffer taken by its BufNode
+};
+
+// Arena fields under `prefix` ("" for an ArenaAllocator, "arena." for a pool)
+static ArenaLayout ClassifyArenaAt(SBTarget target, SBType type, const std::string& prefix) {
+    ArenaLayout layout;
+    SBType first_type, end_type;
+    if (!FieldPathOffset(type, prefix + "state.buffer_list.first", layout.first_offset, first_type) ||
+        !FieldPathOffset(type, prefix + "state.end_index", layout.end_index_offset, end_type)) {
+        return layout;
+    }
+    layout.word_size = end_type.GetByteSize();
+    SBType node = first_type.GetCanonicalType().GetPointeeType();
+    ClassifyLinkedListNode(node, layout.buffers);
+    if (!layout.buffers.valid) return layout;
+    if (layout.buffers.has_data) {
+        layout.data_offset = (int64_t)layout.buffers.data_offset;
+        layout.header_size = node.GetByteSize();
+    } else {
+        uint64_t arena_offset;
+        SBType arena_type = type;
+        if (!prefix.empty() && !FieldPathOffset(type, prefix.substr(0, prefix.size() - 1), arena_offset, arena_type)) {
+            return layout;
+        }
+        const char* arena_name = arena_type.GetName();
+        SBType buf_node = target.FindFirstType((std::string(arena_name ? arena_name : "") + ".BufNode").c_str());
+        uint64_t data_offset = 0, node_offset = layout.word_size;
+        SBType unused;
+        layout.header_size = 2 * layout.word_size;
+        // Without the BufNode type, assume its declared order { data, node }
+        if (buf_node.IsValid() && FieldPathOffset(buf_node, "data", data_offset, unused) &&
+            FieldPathOffset(buf_node, "node", node_offset, unused)) {
+            layout.header_size = buf_node.GetByteSize();
+        }
+        layout.data_offset = (int64_t)data_offset - (int64_t)node_offset;
+    }
+    layout.valid = layout.word_size > 0 && layout.word_size <= 8;
+    return layout;
+}
+
+static ArenaLayout ClassifyArena(TargetType source) {
+    return ClassifyArenaAt(source.target, source.type.GetCanonicalType(), "");
+}
+
+static TypeLayoutCache<ArenaLayout> g_arena_layouts;
+
+struct ArenaStats {
+    LinkedListWalk walk;
+    uint64_t used = 0;       // end_index plus the capacity of older buffers
+    uint64_t reserved = 0;   // bytes obtained from the child allocator
+    uint64_t capacity = 0;   // reserved minus BufNode headers
+};
+
+// Walk the buffer list (bounded, cycle-checked, through the read cache) and
+// total the buffer lengths. Older buffers count as full: the arena keeps no
+// record of the space it left at their tails.
+static bool ReadArenaStats(SBValue value, const ArenaLayout& layout, uint64_t budget, ArenaStats& stats) {
+    uint8_t word[8];
+    if (!ReadValueBytes(value, layout.first_offset, word, layout.word_size)) return false;
+    uint64_t first = LoadUnsigned(word, layout.word_size);
+    if (!ReadValueBytes(value, layout.end_index_offset, word, layout.word_size)) return false;
+    uint64_t end_index = LoadUnsigned(word, layout.word_size);
+
+    SBProcess process = value.GetProcess();
+    WalkLinkedList(process, layout.buffers, first, budget, budget, stats.walk);
+    for (size_t i = 0; i < stats.walk.nodes.size(); i++) {
+        uint64_t len = 0;
+        if (!g_read_cache.ReadPointer(process, stats.walk.nodes[i] + layout.data_offset, layout.word_size, len)) {
+            return false;
+        }
+        uint64_t payload = len > layout.header_size ? len - layout.header_size : 0;
+        stats.reserved += len;
+        stats.capacity += payload;
+        stats.used += i == 0 ? std::min(end_index, payload) : payload;
+    }
+    return true;
+}
+
+// MemoryPoolExtra(Item, ...) { arena, free_list: ?*Node } with Node { next }
+// placed in freed items
+struct MemoryPoolLayout {
+    bool valid = false;
+    ArenaLayout arena;
+    uint64_t free_list_offset = 0;
+    LinkedListLayout free_nodes;
+};
+
+static MemoryPoolLayout ClassifyMemoryPool(TargetType source) {
+    MemoryPoolLayout layout;
+    SBType type = source.type.GetCanonicalType();
+    SBType free_type;
+    if (!FieldPathOffset(type, "free_list", layout.free_list_offset, free_type)) return layout;
+    ClassifyLinkedListNode(free_type.GetCanonicalType().GetPointeeType(), layout.free_nodes);
+    layout.arena = ClassifyArenaAt(source.target, type, "arena.");
+    layout.valid = layout.free_nodes.valid && layout.arena.valid;
+    return layout;
+}
+
+static TypeLayoutCache<MemoryPoolLayout> g_memory_pool_layouts;
+
+//===----------------------------------------------------------------------===//
+// Debug Allocator
+//===----------------------------------------------------------------------===//
+
+// DebugAllocator(config), formerly GeneralPurposeAllocator, keeps small
+// allocations in one-page buckets per power-of-two size class: slots from the
+// page start, metadata at its end. The metadata is a BucketHeader
+// { allocated_count, freed_count, prev, ... }, a used bit per slot, with
+// safety each slot's requested size and log2 alignment, then two stack
+// traces (alloc, free) per slot. Large allocations sit in a hash map of
+// LargeAlloc { bytes, [requested_size], stack_addresses, [freed], ... }.
+// The comptime config is not in debug info: the page size follows from the
+// number of size classes, the trace depth from LargeAlloc, and safety from
+// where the header sits in its page.
+struct DebugAllocatorLayout {
+    bool valid = false;
+    uint64_t word_size = 8;
+    uint64_t buckets_offset = 0;
+    uint64_t size_classes = 0;
+    uint64_t page_size = 0;
+    uint64_t header_size = 0;
+    LinkedListLayout bucket_list;      // `prev` links older buckets
+    uint64_t size_int_size = 2;        // LargestSizeClassInt
+    uint64_t stack_n = 0;              // frames per trace
+    // LargeAlloc, within one hash map value
+    uint64_t large_len_offset = 0;
+    bool large_has_requested = false;
+    uint64_t large_requested_offset = 0;
+    uint64_t large_trace_offset = 0;
+    bool large_has_freed = false;
+    uint64_t large_freed_offset = 0;
+};
+
+static uint64_t AlignForward(uint64_t value, uint64_t align) {
+    return (value + align - 1) / align * align;
+}
+
+static DebugAllocatorLayout ClassifyDebugAllocator(TargetType source) {
+    DebugAllocatorLayout layout;
+    SBType type = source.type.GetCanonicalType();
+    SBType buckets_type, unused;
+    uint64_t offset;
+    if (!FieldPathOffset(type, "buckets", layout.buckets_offset, buckets_type) ||
+        !FieldPathOffset(type, "large_allocations", offset, unused)) {
+        return layout;
+    }
+    buckets_type = buckets_type.GetCanonicalType();
+    SBType header_ptr = buckets_type.GetArrayElementType().GetCanonicalType();
+    layout.word_size = header_ptr.GetByteSize();
+    if (layout.word_size == 0 || layout.word_size > 8) return layout;
+    // small_bucket_count = log2(page_size) - 1
+    layout.size_classes = buckets_type.GetByteSize() / layout.word_size;
+    if (layout.size_classes < 2 || layout.size_classes > 40) return layout;
+    layout.page_size = 1ull << (layout.size_classes + 1);
+    // LargestSizeClassInt holds 0 ... 2^(size_classes - 1)
+    uint64_t bits = layout.size_classes;
+    layout.size_int_size = bits <= 8 ? 1 : bits <= 16 ? 2 : bits <= 32 ? 4 : 8;
+
+    SBType header = header_ptr.GetPointeeType().GetCanonicalType();
+    layout.header_size = header.GetByteSize();
+    if (layout.header_size == 0 ||
+        !FieldPathOffset(header, "prev", layout.bucket_list.next_offset, unused)) {
+        return layout;
+    }
+    layout.bucket_list.valid = true;
+    layout.bucket_list.word_size = layout.word_size;
+
+    const char* name = source.type.GetName();
+    SBType large = source.target.FindFirstType((std::string(name ? name : "") + ".LargeAlloc").c_str());
+    SBType trace_type;
+    if (!large.IsValid() ||
+        !FieldPathOffset(large, "bytes.len", layout.large_len_offset, unused) ||
+        !FieldPathOffset(large, "stack_addresses", layout.large_trace_offset, trace_type)) {
+        return layout;
+    }
+    // [trace_n][stack_n]usize
+    SBType one_trace = trace_type.GetCanonicalType().GetArrayElementType();
+    layout.stack_n = one_trace.GetByteSize() / layout.word_size;
+    SBType field_type;
+    layout.large_has_requested = FieldPathOffset(large, "requested_size", layout.large_requested_offset, field_type) &&
+                                 field_type.GetByteSize() == layout.word_size;
+    layout.large_has_freed = FieldPathOffset(large, "freed", layout.large_freed_offset, field_type) &&
+                             field_type.GetByteSize() == 1;
+    layout.valid = true;
+    return layout;
+}
+
+static TypeLayoutCache<DebugAllocatorLayout> g_debug_allocator_layouts;
+
+// Bucket metadata offsets, mirroring bucketSize() and friends
+struct BucketGeometry {
+    uint64_t slot_count = 0;
+    uint64_t requested_sizes = 0;   // offset from the header (safety only)
+    uint64_t traces = 0;            // offset of the stack traces
+    uint64_t size = 0;              // metadata bytes
+};
+
+static BucketGeometry BucketGeometryFor(const DebugAllocatorLayout& layout, bool safety, uint64_t slots) {
+    BucketGeometry g;
+    g.slot_count = slots;
+    uint64_t used_bits = (slots + 8 * layout.word_size - 1) / (8 * layout.word_size) * layout.word_size;
+    uint64_t start = layout.header_size + used_bits;
+    if (safety) {
+        g.requested_sizes = AlignForward(start, layout.size_int_size);
+        start = g.requested_sizes + layout.size_int_size * slots + slots;
+    }
+    g.traces = AlignForward(start, layout.word_size);
+    g.size = g.traces + 2 * layout.stack_n * layout.word_size * slots;
+    return g;
+}
+
+// calculateSlotCount(): the most slots whose metadata still fits behind them
+static BucketGeometry BucketGeometryForClass(const DebugAllocatorLayout& layout, bool safety, uint64_t index) {
+    uint64_t size_class = 1ull << index;
+    uint64_t lower = 2;
+    uint64_t first = BucketGeometryFor(layout, safety, lower).size;
+    uint64_t upper = first < layout.page_size ? (layout.page_size - first) / size_class : lower;
+    while (upper > lower) {
+        uint64_t proposed = lower + (upper - lower) / 2;
+        if (proposed == lower) break;
+        uint64_t end = AlignForward(proposed * size_class, layout.word_size) +
+                       BucketGeometryFor(layout, safety, proposed).size;
+        if (end > layout.page_size) {
+            upper = proposed - 1;
+        } else {
+            lower = proposed;
+        }
+    }
+    return BucketGeometryFor(layout, safety, lower);
+}
+
+// Live bytes and allocation count for one allocation stack trace
+struct HeapSite {
+    uint64_t bytes = 0;
+    uint64_t count = 0;
+};
+
+typedef std::map<std::vector<uint64_t>, HeapSite> HeapProfile;
+
+struct HeapWalk {
+    HeapProfile sites;
+    uint64_t small_count = 0;
+    uint64_t small_bytes = 0;
+    uint64_t large_count = 0;
+    uint64_t large_bytes = 0;
+    uint64_t buckets = 0;
+    uint64_t skipped_buckets = 0;   // unreadable or unrecognized
+};
+
+static void AddHeapSample(HeapWalk& walk, const uint8_t* trace, uint64_t stack_n, uint64_t word_size,
+                          uint64_t bytes) {
+    std::vector<uint64_t> frames;
+    for (uint64_t i = 0; i < stack_n; i++) {
+        uint64_t addr = LoadUnsigned(trace + i * word_size, word_size);
+        if (addr == 0) break;
+        frames.push_back(addr);
+    }
+    HeapSite& site = walk.sites[frames];
+    site.bytes += bytes;
+    site.count++;
+}
+
+static constexpr uint64_t kHeapBucketBudget = 1 << 20;
+
+// Every bucket of every size class: one read of each bucket's metadata,
+// then the used bits pick the live slots
+static void WalkDebugAllocatorBuckets(SBValue value, const DebugAllocatorLayout& layout, HeapWalk& walk) {
+    SBProcess process = value.GetProcess();
+    std::vector<uint8_t> heads(layout.size_classes * layout.word_size);
+    if (!ReadValueBytes(value, layout.buckets_offset, heads.data(), heads.size())) return;
+    std::vector<uint8_t> meta;
+    for (uint64_t index = 0; index < layout.size_classes; index++) {
+        uint64_t head = LoadUnsigned(&heads[index * layout.word_size], layout.word_size);
+        if (head == 0) continue;
+        LinkedListWalk buckets;
+        WalkLinkedList(process, layout.bucket_list, head, kHeapBucketBudget, kHeapBucketBudget, buckets);
+
+        uint64_t size_class = 1ull << index;
+        BucketGeometry shapes[2] = {BucketGeometryForClass(layout, true, index),
+                                    BucketGeometryForClass(layout, false, index)};
+        for (uint64_t header : buckets.nodes) {
+            walk.buckets++;
+            // The header sits at the aligned-down start of the metadata,
+            // which tells the two layouts apart
+            uint64_t page = header & ~(layout.page_size - 1);
+            const BucketGeometry* g = nullptr;
+            for (const BucketGeometry& shape : shapes) {
+                uint64_t expected = (page + layout.page_size - shape.size) & ~(layout.word_size - 1);
+                if (expected == header) {
+                    g = &shape;
+                    break;
+                }
+            }
+            if (!g || !ReadTargetMemory(process, header, g->size, meta)) {
+                walk.skipped_buckets++;
+                continue;
+            }
+            bool safety = g == &shapes[0];
+            const uint8_t* used = meta.data() + layout.header_size;
+            for (uint64_t slot = 0; slot < g->slot_count; slot++) {
+                if (!(used[slot / 8] & (1u << (slot % 8)))) continue;
+                uint64_t bytes = safety ? LoadUnsigned(&meta[g->requested_sizes + slot * layout.size_int_size],
+                                                       layout.size_int_size)
+                                        : size_class;
+                AddHeapSample(walk, &meta[g->traces + slot * 2 * layout.stack_n * layout.word_size],
+                              layout.stack_n, layout.word_size, bytes);
+                walk.small_count++;
+                walk.small_bytes += bytes;
+            }
+        }
+    }
+}
+
+// The large-allocation map: metadata, then the values of used slots, in
+// bulk reads
+static void WalkDebugAllocatorLarge(SBValue value, const DebugAllocatorLayout& layout, HeapWalk& walk) {
+    SBValue map = ResolveHashMapUnmanaged(value.GetChildMemberWithName("large_allocations"));
+    const HashMapLayout& map_layout = g_hash_map_layouts.Get(map, ClassifyHashMap);
+    HashMapState state;
+    if (!ReadHashMapState(map, map_layout, state) || state.metadata == 0 || map_layout.value_size == 0) return;
+    SBProcess process = value.GetProcess();
+    std::vector<uint8_t> metadata, values;
+    if (!ReadTargetMemory(process, state.metadata, state.capacity, metadata)) return;
+    std::vector<uint64_t> used;
+    zdb::CollectUsedSlots(metadata.data(), metadata.size(), 0, metadata.size(), used);
+    if (used.empty()) return;
+
+    uint64_t value_size = map_layout.value_size;
+    uint64_t first = used.front(), span = used.back() - first + 1;
+    if (!ReadTargetMemory(process, state.values + first * value_size, span * value_size, values)) return;
+    for (uint64_t idx : used) {
+        const uint8_t* entry = values.data() + (idx - first) * value_size;
+        if (layout.large_has_freed && entry[layout.large_freed_offset]) continue;
+        uint64_t bytes = LoadUnsigned(entry + (layout.large_has_requested ? layout.large_requested_offset
+                                                                          : layout.large_len_offset),
+                                      layout.word_size);
+        AddHeapSample(walk, entry + layout.large_trace_offset, layout.stack_n, layout.word_size, bytes);
+        walk.large_count++;
+        walk.large_bytes += bytes;
+    }
+}
+
+static bool IsZigDebugAllocator(SBValue value) {
+    const char* name = value.GetTypeName();
+    return name && (strncmp(name, "heap.debug_allocator.DebugAllocator(", 36) == 0 ||
+                    strncmp(name, "heap.general_purpose_allocator.GeneralPurposeAllocator(", 55) == 0);
+}
+
+// "name at file:line" for a return address, looked up at addr - 1 so the
+// line is the call's rather than the next statement's
+static std::string SymbolizeReturnAddress(SBTarget target, uint64_t addr) {
+    uint64_t call = addr > 0 ? addr - 1 : addr;
+    SymbolIndex::Hit hit;
+    std::string text;
+    if (g_symbol_index.Lookup(target, call, hit)) {
+        text = hit.name;
+    } else {
+        char buf[32];
+        snprintf(buf, sizeof(buf), "0x%llx", (unsigned long long)addr);
+        text = buf;
+    }
+    // Line tables are only consulted for the file:line
+    SBSymbolContext context = target.ResolveSymbolContextForAddress(target.ResolveLoadAddress(call),
+                                                                    eSymbolContextLineEntry);
+    SBLineEntry line = context.GetLineEntry();
+    if (line.IsValid() && line.GetFileSpec().GetFilename()) {
+        text += std::string(" at ") + line.GetFileSpec().GetFilename() + ":" + std::to_string(line.GetLine());
+    }
+    return text;
+}
+
+// `zig heap --save` snapshots, for --diff
+static std::mutex g_heap_snapshots_mutex;
+static std::map<std::string, HeapProfile> g_heap_snapshots;
+
+//===----------------------------------------------------------------------===//
+// Lock Contention
+//===----------------------------------------------------------------------===//
+
+// Blocking std.Thread primitives, by the function-name prefix of their
+// frames. A waiting thread's innermost frames are the wait syscall and a
+// chain of these; the outermost one in the chain is the lock the caller
+// used, and its `self` is the lock's address.
+enum class LockKind { Mutex, RwLock, Condition, Semaphore, ResetEvent, WaitGroup, Futex, Count };
+
+static const char* const kLockKindNames[] = {
+    "Mutex", "RwLock", "Condition", "Semaphore", "ResetEvent", "WaitGroup", "Futex"};
+
+static bool LockFrameKind(const char* function, LockKind& kind) {
+    static const char* const kPrefixes[] = {
+        "Thread.Mutex.", "Thread.RwLock.", "Thread.Condition.", "Thread.Semaphore.",
+        "Thread.ResetEvent.", "Thread.WaitGroup.", "Thread.Futex."};
+    if (!function) return false;
+    for (int i = 0; i < (int)LockKind::Count; i++) {
+        if (strstr(function, kPrefixes[i])) {
+            kind = (LockKind)i;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Frames below the first lock frame may belong to libc or the kernel
+// (syscall, __ulock_wait, os_unfair_lock_lock, ...)
+static constexpr uint32_t kLockLeafFrames = 6;
+
+struct LockWaiter {
+    uint32_t thread_index = 0;      // SBThread::GetIndexID
+    uint64_t tid = 0;
+    LockKind kind = LockKind::Futex;
+    uint64_t lock_addr = 0;         // 0 when `self` is unavailable
+    SBValue lock;                   // the lock value, for decoding its state
+    std::string site;               // first frame outside the chain
+};
+
+// "function (file:line)"
+static std::string FrameSite(SBFrame frame) {
+    const char* name = frame.GetFunctionName();
+    std::string text = name ? name : "??";
+    SBLineEntry line = frame.GetLineEntry();
+    if (line.IsValid() && line.GetFileSpec().GetFilename()) {
+        text += std::string(" (") + line.GetFileSpec().GetFilename() + ":" + std::to_string(line.GetLine()) + ")";
+    }
+    return text;
+}
+
+// The lock a thread is blocked on, if its innermost frames are a wait
+static bool FindLockWait(SBThread thread, uint32_t max_depth, LockWaiter& waiter) {
+    uint32_t depth = std::min(thread.GetNumFrames(), max_depth);
+    uint32_t i = 0;
+    LockKind kind;
+    while (i < depth && i < kLockLeafFrames && !LockFrameKind(thread.GetFrameAtIndex(i).GetFunctionName(), kind)) i++;
+    if (i >= depth || i >= kLockLeafFrames) return false;
+
+    SBFrame outermost;
+    for (; i < depth; i++) {
+        SBFrame frame = thread.GetFrameAtIndex(i);
+        if (!LockFrameKind(frame.GetFunctionName(), kind)) break;
+        outermost = frame;
+        waiter.kind = kind;
+    }
+    waiter.thread_index = thread.GetIndexID();
+    waiter.tid = thread.GetThreadID();
+    waiter.site = i < depth ? FrameSite(thread.GetFrameAtIndex(i)) : "??";
+    // Methods take `self`; Futex.wait takes `ptr`
+    SBValue self = outermost.FindVariable(waiter.kind == LockKind::Futex ? "ptr" : "self");
+    if (self.IsValid() && self.GetType().IsPointerType()) {
+        waiter.lock_addr = self.GetValueAsUnsigned(0);
+        waiter.lock = self.Dereference();
+    }
+    return true;
+}
+
+// First field named `name` at any depth (breadth-first), unwrapping
+// atomic.Value's `raw`
+static SBValue FindLockField(SBValue value, const char* name) {
+    std::vector<SBValue> level{value};
+    for (int depth = 0; depth < 4 && !level.empty(); depth++) {
+        std::vector<SBValue> next;
+        for (SBValue& v : level) {
+            SBValue field = v.GetChildMemberWithName(name);
+            if (field.IsValid()) {
+                SBValue raw = field.GetChildMemberWithName("raw");
+                return raw.IsValid() ? raw : field;
+            }
+            for (uint32_t i = 0; i < v.GetNumChildren(16); i++) next.push_back(v.GetChildAtIndex(i));
+        }
+        level.swap(next);
+    }
+    return SBValue();
+}
+
+// Decoded lock word, plus the owner when the lock records one (Debug-mode
+// Mutex keeps `locking_thread`)
+static std::string DescribeLockState(SBValue lock, LockKind kind, uint64_t& owner_tid) {
+    owner_tid = 0;
+    if (!lock.IsValid()) return "";
+    char buf[128];
+    SBValue owner = FindLockField(lock, "locking_thread");
+    if (owner.IsValid()) owner_tid = owner.GetValueAsUnsigned(0);
+    SBValue state = FindLockField(lock, "state");
+    if (kind == LockKind::Mutex) {
+        if (!state.IsValid()) state = FindLockField(lock, "oul");   // os_unfair_lock on Darwin
+        if (!state.IsValid()) return "";
+        uint64_t word = state.GetValueAsUnsigned(0);
+        // FutexImpl: 0 unlocked, 1 locked, 3 locked with waiters
+        snprintf(buf, sizeof(buf), "%s", word == 0 ? "unlocked" : word == 3 ? "contended" : "locked");
+        return buf;
+    }
+    if (kind == LockKind::RwLock && state.IsValid() && state.GetByteSize() >= 4) {
+        // DefaultRwLock: bit 0 writing, then pending writers, then readers,
+        // each count half of the remaining bits
+        uint64_t word = state.GetValueAsUnsigned(0);
+        uint32_t count_bits = (uint32_t)(state.GetByteSize() * 8 - 1) / 2;
+        uint64_t mask = (1ull << count_bits) - 1;
+        snprintf(buf, sizeof(buf), "writing=%d writers_waiting=%llu readers=%llu", (int)(word & 1),
+            (unsigned long long)((word >> 1) & mask), (unsigned long long)((word >> (1 + count_bits)) & mask));
+        return buf;
+    }
+    if (kind == LockKind::Semaphore) {
+        SBValue permits = FindLockField(lock, "permits");
+        if (permits.IsValid()) {
+            snprintf(buf, sizeof(buf), "permits=%llu", (unsigned long long)permits.GetValueAsUnsigned(0));
+            return buf;
+        }
+    }
+    if (kind == LockKind::Futex) {
+        // Futex.wait takes *const atomic.Value(u32); the word is its `raw`
+        SBValue raw = lock.GetChildMemberWithName("raw");
+        uint64_t word = (raw.IsValid() ? raw : lock).GetValueAsUnsigned(0);
+        snprintf(buf, sizeof(buf), "value=%llu", (unsigned long long)word);
+        return buf;
+    }
+    if (state.IsValid()) {
+        snprintf(buf, sizeof(buf), "state=%llu", (unsigned long long)state.GetValueAsUnsigned(0));
+        return buf;
+    }
+    return "";
+}
+
+//===----------------------------------------------------------------------===//
+// io_uring
+//===----------------------------------------------------------------------===//
+
+// os.linux.IoUring { fd, sq, cq, flags, features }. The ring indices live in
+// memory shared with the kernel, reached through pointers in sq and cq:
+//   sq { head, tail, mask, flags, dropped: *u32, array, sqes, mmap,
+//        sqe_head, sqe_tail: u32 }
+//   cq { head, tail: *u32, mask, overflow: *u32, cqes: []io_uring_cqe }
+// sqe_head..sqe_tail are SQEs prepared but not yet flushed to the ring.
+struct IoUringLayout {
+    bool valid = false;
+    uint64_t word_size = 8;
+    uint64_t fd_offset = 0;
+    uint64_t sq_head = 0, sq_tail = 0, sq_flags = 0, sq_dropped = 0, sq_sqes = 0;
+    uint64_t sqe_head = 0, sqe_tail = 0;
+    uint64_t cq_head = 0, cq_tail = 0, cq_mask = 0, cq_overflow = 0, cq_cqes = 0;
+    uint64_t cqe_size = 0;
+};
+
+static IoUringLayout ClassifyIoUring(SBType type) {
+    IoUringLayout layout;
+    type = type.GetCanonicalType();
+    SBType field_type, cqes_type;
+    uint64_t* offsets[] = {&layout.fd_offset, &layout.sq_head, &layout.sq_tail, &layout.sq_flags,
+        &layout.sq_dropped, &layout.sq_sqes, &layout.sqe_head, &layout.sqe_tail, &layout.cq_head,
+        &layout.cq_tail, &layout.cq_mask, &layout.cq_overflow};
+    const char* paths[] = {"fd", "sq.head", "sq.tail", "sq.flags", "sq.dropped", "sq.sqes", "sq.sqe_head",
+        "sq.sqe_tail", "cq.head", "cq.tail", "cq.mask", "cq.overflow"};
+    for (size_t i = 0; i < sizeof(paths) / sizeof(paths[0]); i++) {
+        if (!FieldPathOffset(type, paths[i], *offsets[i], field_type)) return layout;
+    }
+    if (!FieldPathOffset(type, "cq.cqes", layout.cq_cqes, cqes_type)) return layout;
+    layout.word_size = field_type.GetByteSize();   // cq.overflow: *u32
+    SBType cqe = cqes_type.GetCanonicalType().GetFieldAtIndex(0).GetType().GetPointeeType();
+    layout.cqe_size = cqe.GetByteSize();
+    layout.valid = layout.word_size > 0 && layout.word_size <= 8 && layout.cqe_size >= 16;
+    return layout;
+}
+
+static TypeLayoutCache<IoUringLayout> g_io_uring_layouts;
+
+// IORING_SQ_* bits of the shared sq flags word
+static constexpr uint32_t kSqNeedWakeup = 1;
+static constexpr uint32_t kSqCqOverflow = 2;
+static constexpr uint32_t kSqTaskrun = 4;
+
+struct IoUringState {
+    int32_t fd = -1;
+    uint32_t sq_head = 0, sq_tail = 0, sq_flags = 0, sq_dropped = 0;
+    uint32_t sqe_head = 0, sqe_tail = 0;
+    uint64_t sq_entries = 0;
+    uint32_t cq_head = 0, cq_tail = 0, cq_mask = 0, cq_overflow = 0;
+    uint64_t cqes = 0, cq_entries = 0;
+
+    uint32_t Unsubmitted() const { return sqe_tail - sqe_head; }
+    // Flushed to the ring but not yet consumed by the kernel
+    uint32_t SqPending() const { return sq_tail - sq_head; }
+    uint32_t CqReady() const { return cq_tail - cq_head; }
+};
+
+// The struct's own fields come from its data; the seven shared words go
+// through the read cache, which serves them from the one or two ring pages
+static bool ReadIoUringState(SBValue value, const IoUringLayout& layout, IoUringState& state) {
+    if (!layout.valid) return false;
+    uint8_t word[8];
+    auto field = [&](uint64_t offset, uint64_t size, uint64_t& out) {
+        if (!ReadValueBytes(value, offset, word, size)) return false;
+        out = LoadUnsigned(word, size);
+        return true;
+    };
+    SBProcess process = value.GetProcess();
+    auto shared = [&](uint64_t offset, uint32_t& out) {
+        uint64_t addr, word32;
+        if (!field(offset, layout.word_size, addr) || addr == 0 ||
+            !g_read_cache.ReadPointer(process, addr, 4, word32)) {
+            return false;
+        }
+        out = (uint32_t)word32;
+        return true;
+    };
+    uint64_t fd, mask, sqe_head, sqe_tail;
+    if (!field(layout.fd_offset, 4, fd) || !field(layout.cq_mask, 4, mask) ||
+        !field(layout.sqe_head, 4, sqe_head) || !field(layout.sqe_tail, 4, sqe_tail) ||
+        !field(layout.sq_sqes + layout.word_size, layout.word_size, state.sq_entries) ||
+        !field(layout.cq_cqes, layout.word_size, state.cqes) ||
+        !field(layout.cq_cqes + layout.word_size, layout.word_size, state.cq_entries)) {
+        return false;
+    }
+    state.fd = (int32_t)fd;
+    state.cq_mask = (uint32_t)mask;
+    state.sqe_head = (uint32_t)sqe_head;
+    state.sqe_tail = (uint32_t)sqe_tail;
+    return shared(layout.sq_head, state.sq_head) && shared(layout.sq_tail, state.sq_tail) &&
+           shared(layout.sq_flags, state.sq_flags) && shared(layout.sq_dropped, state.sq_dropped) &&
+           shared(layout.cq_head, state.cq_head) && shared(layout.cq_tail, state.cq_tail) &&
+           shared(layout.cq_overflow, state.cq_overflow);
+}
+
+// "fd=N sq: pending=P unsubmitted=U entries=E cq: ready=R entries=E ..."
+static void PrintIoUringState(const IoUringState& state, SBStream& stream) {
+    stream.Printf("fd=%d sq: pending=%u unsubmitted=%u entries=%llu cq: ready=%u entries=%llu", state.fd,
+        state.SqPending(), state.Unsubmitted(), (unsigned long long)state.sq_entries, state.CqReady(),
+        (unsigned long long)state.cq_entries);
+    if (state.sq_dropped) stream.Printf(" dropped=%u", state.sq_dropped);
+    if (state.cq_overflow) stream.Printf(" overflow=%u", state.cq_overflow);
+    if (state.sq_flags & kSqNeedWakeup) stream.Printf(" need-wakeup");
+    if (state.sq_flags & kSqCqOverflow) stream.Printf(" cq-overflow");
+    if (state.sq_flags & kSqTaskrun) stream.Printf(" taskrun");
+}
+
+// Linux errno names for the results io_uring completions commonly carry
+static const char* LinuxErrnoName(int32_t err) {
+    switch (err) {
+    case 2: return "ENOENT";
+    case 4: return "EINTR";
+    case 5: return "EIO";
+    case 9: return "EBADF";
+    case 11: return "EAGAIN";
+    case 12: return "ENOMEM";
+    case 14: return "EFAULT";
+    case 16: return "EBUSY";
+    case 22: return "EINVAL";
+    case 32: return "EPIPE";
+    case 62: return "ETIME";
+    case 104: return "ECONNRESET";
+    case 105: return "ENOBUFS";
+    case 110: return "ETIMEDOUT";
+    case 111: return "ECONNREFUSED";
+    case 125: return "ECANCELED";
+    default: return nullptr;
+    }
+}
+
+// IORING_CQE_F_* bits
+static std::string CqeFlagsText(uint32_t flags) {
+    static const char* const kNames[] = {"buffer", "more", "sock-nonempty", "notif"};
+    std::string text;
+    for (int i = 0; i < 4; i++) {
+        if (!(flags & (1u << i))) continue;
+        if (!text.empty()) text += "|";
+        text += kNames[i];
+    }
+    // Provided-buffer id in the upper 16 bits
+    if ((flags & 1) && (flags >> 16)) text += " bid=" + std::to_string(flags >> 16);
+    return text;
+}
+
+//===----------------------------------------------------------------------===//
+// Interfaces
+//===----------------------------------------------------------------------===//
+
+// Results keyed by load address, kept for the life of the process: code and
+// vtables do not move, and the same few vtables sit behind every interface
+// value. Dropped when the process changes or modules load (an address may
+// only now have a symbol).
+template <typename Value>
+class AddressCache {
+public:
+    template <typename Compute>
+    Value Get(SBTarget target, uint64_t addr, Compute compute) {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            Sync(target);
+            auto it = m_values.find(addr);
+            if (it != m_values.end()) return it->second;
+        }
+        Value value = compute();
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_values.emplace(addr, value);
+        return value;
+    }
+
+private:
+    void Sync(SBTarget target) {
+        uint32_t process_id = target.GetProcess().GetUniqueID();
+        uint32_t modules = target.GetNumModules();
+        if (process_id != m_process_id || modules != m_modules) {
+            m_values.clear();
+            m_process_id = process_id;
+            m_modules = modules;
+        }
+    }
+
+    std::mutex m_mutex;
+    uint32_t m_process_id = 0;
+    uint32_t m_modules = 0;
+    std::unordered_map<uint64_t, Value> m_values;
+};
+
+// Name of the symbol containing `addr`, or ""
+static std::string SymbolNameAt(SBTarget target, uint64_t addr) {
+    SymbolIndex::Hit hit;
+    return g_symbol_index.Lookup(target, addr, hit) ? hit.name : "";
+}
+
+// "heap.arena_allocator.ArenaAllocator" for
+// "heap.arena_allocator.ArenaAllocator.alloc"
+static std::string SymbolContainer(const std::string& name) {
+    size_t dot = name.rfind('.');
+    return dot == std::string::npos ? "" : name.substr(0, dot);
+}
+
+// Concrete type behind a vtable. A named `const vtable` gives it directly;
+// anonymous vtables (`&.{ .alloc = alloc, ... }`) give it through the
+// function in their first entry.
+struct InterfaceImpl {
+    std::string name;
+    SBType type;        // invalid when debug info lacks it
+};
+
+static AddressCache<InterfaceImpl> g_interface_impls;
+
+static InterfaceImpl ResolveInterfaceImpl(SBTarget target, uint64_t vtable, uint64_t word_size) {
+    return g_interface_impls.Get(target, vtable, [&]() {
+        InterfaceImpl impl;
+        std::string symbol = SymbolNameAt(target, vtable);
+        static const std::string kSuffix = ".vtable";
+        if (symbol.size() > kSuffix.size() &&
+            symbol.compare(symbol.size() - kSuffix.size(), kSuffix.size(), kSuffix) == 0) {
+            impl.name = SymbolContainer(symbol);
+        } else {
+            uint64_t function = 0;
+            if (g_read_cache.ReadPointer(target.GetProcess(), vtable, word_size, function) && function != 0) {
+                impl.name = SymbolContainer(SymbolNameAt(target, function));
+            }
+        }
+        if (!impl.name.empty()) impl.type = target.FindFirstType(impl.name.c_str());
+        return impl;
+    });
+}
+
+// { ptr: *anyopaque, vtable: *const VTable } (mem.Allocator and friends)
+struct InterfaceLayout {
+    bool valid = false;
+    uint64_t ptr_offset = 0;
+    uint64_t vtable_offset = 0;
+    uint64_t word_size = 8;
+};
+
+static InterfaceLayout ClassifyInterface(SBType type) {
+    InterfaceLayout layout;
+    SBType ptr_type, vtable_type;
+    type = type.GetCanonicalType();
+    if (!FieldPathOffset(type, "ptr", layout.ptr_offset, ptr_type) ||
+        !FieldPathOffset(type, "vtable", layout.vtable_offset, vtable_type)) {
+        return layout;
+    }
+    layout.word_size = vtable_type.GetByteSize();
+    layout.valid = layout.word_size > 0 && layout.word_size <= 8 && ptr_type.GetByteSize() == layout.word_size;
+    return layout;
+}
+
+static TypeLayoutCache<InterfaceLayout> g_interface_layouts;
+
+//===----------------------------------------------------------------------===//
+// I/O Buffers
+//===----------------------------------------------------------------------===//
+
+// Io.Reader { vtable, buffer: []u8, seek, end } holds buffer[seek..end];
+// Io.Writer { vtable, buffer: []u8, end } holds buffer[0..end]. The older
+// io.BufferedReader(N, R) { unbuffered_reader, buf: [N]u8, start, end } and
+// BufferedWriter(N, W) { unbuffered_writer, buf: [N]u8, end } keep the
+// buffer inline and name the implementation in their field type.
+struct IoBufferLayout {
+    bool valid = false;
+    bool inline_buffer = false;
+    bool has_seek = false;
+    bool has_vtable = false;
+    uint64_t word_size = 8;
+    uint64_t buffer_offset = 0;      // the array, or the slice's ptr (len follows)
+    uint64_t inline_capacity = 0;
+    uint64_t seek_offset = 0;        // `seek`, or `start` for BufferedReader
+    uint64_t end_offset = 0;
+    uint64_t vtable_offset = 0;
+    std::string impl;                // from the unbuffered field's type
+};
+
+static IoBufferLayout ClassifyIoBuffer(SBType type) {
+    IoBufferLayout layout;
+    type = type.GetCanonicalType();
+    bool have_buffer = false, have_end = false;
+    for (uint32_t i = 0; i < type.GetNumberOfFields(); i++) {
+        SBTypeMember field = type.GetFieldAtIndex(i);
+        const char* name = field.GetName();
+        if (!name) continue;
+        SBType field_type = field.GetType().GetCanonicalType();
+        if (strcmp(name, "buffer") == 0 || strcmp(name, "buf") == 0) {
+            layout.buffer_offset = field.GetOffsetInBytes();
+            if (field_type.IsArrayType()) {
+                layout.inline_buffer = true;
+                layout.inline_capacity = field_type.GetByteSize();
+            }
+            have_buffer = true;
+        } else if (strcmp(name, "seek") == 0 || strcmp(name, "start") == 0) {
+            layout.seek_offset = field.GetOffsetInBytes();
+            layout.has_seek = true;
+        } else if (strcmp(name, "end") == 0) {
+            layout.end_offset = field.GetOffsetInBytes();
+            layout.word_size = field_type.GetByteSize();
+            have_end = true;
+        } else if (strcmp(name, "vtable") == 0) {
+            layout.vtable_offset = field.GetOffsetInBytes();
+            layout.has_vtable = true;
+        } else if (strcmp(name, "unbuffered_reader") == 0 || strcmp(name, "unbuffered_writer") == 0) {
+            const char* impl = field.GetType().GetName();
+            if (impl) layout.impl = impl;
+        }
+    }
+    layout.valid = have_buffer && have_end && layout.word_size > 0 && layout.word_size <= 8;
+    return layout;
+}
+
+static TypeLayoutCache<IoBufferLayout> g_io_buffer_layouts;
+
+struct IoBufferState {
+    uint64_t data = 0;        // buffer address (slice buffers)
+    uint64_t capacity = 0;
+    uint64_t seek = 0;
+    uint64_t end = 0;
+
+    uint64_t Buffered() const { return end - seek; }
+};
+
+static bool ReadIoBufferState(SBValue value, const IoBufferLayout& layout, IoBufferState& state) {
+    if (!layout.valid) return false;
+    uint8_t word[8];
+    if (!ReadValueBytes(value, layout.end_offset, word, layout.word_size)) return false;
+    state.end = LoadUnsigned(word, layout.word_size);
+    if (layout.has_seek) {
+        if (!ReadValueBytes(value, layout.seek_offset, word, layout.word_size)) return false;
+        state.seek = LoadUnsigned(word, layout.word_size);
+    }
+    if (layout.inline_buffer) {
+        state.capacity = layout.inline_capacity;
+    } else {
+        if (!ReadValueBytes(value, layout.buffer_offset, word, layout.word_size)) return false;
+        state.data = LoadUnsigned(word, layout.word_size);
+        if (!ReadValueBytes(value, layout.buffer_offset + layout.word_size, word, layout.word_size)) return false;
+        state.capacity = LoadUnsigned(word, layout.word_size);
+    }
+    // A stale or corrupted interface must not send us reading past the buffer
+    return state.seek <= state.end && state.end <= state.capacity;
+}
+
+// The first `size` buffered bytes, in one read
+static bool ReadIoBufferPreview(SBValue value, const IoBufferLayout& layout, const IoBufferState& state,
+                                size_t size, std::string& out) {
+    out.assign(size, '\0');
+    if (size == 0) return true;
+    if (layout.inline_buffer) return ReadValueBytes(value, layout.buffer_offset + state.seek, &out[0], size);
+    return g_read_cache.Read(value.GetProcess(), state.data + state.seek, &out[0], size);
+}
+
+// Zig string-literal escapes, so binary protocol bytes stay on one line
+static std::string EscapeZigBytes(const std::string& bytes) {
+    std::string out;
+    for (unsigned char c : bytes) {
+        switch (c) {
+        case '"': out += "\\\""; break;
+        case '\\': out += "\\\\"; break;
+        case '\n': out += "\\n"; break;
+        case '\r': out += "\\r"; break;
+        case '\t': out += "\\t"; break;
+        default:
+            if (c < 0x20 || c >= 0x7f) {
+                char esc[8];
+                snprintf(esc, sizeof(esc), "\\x%02x", c);
+                out += esc;
+            } else {
+                out += (char)c;
+            }
+        }
+    }
+    return out;
+}
+
+// Implementation behind an Io.Reader/Io.Writer, e.g. "fs.File.Writer"
+// when the vtable's drain is fs.File.Writer.drain
+static std::string IoImplementationFromVtable(SBValue value, const IoBufferLayout& layout) {
+    uint8_t word[8];
+    if (!layout.has_vtable || !ReadValueBytes(value, layout.vtable_offset, word, layout.word_size)) return "";
+    uint64_t vtable = LoadUnsigned(word, layout.word_size);
+    if (vtable == 0) return "";
+    return ResolveInterfaceImpl(value.GetTarget(), vtable, layout.word_size).name;
+}
+
+//===----------------------------------------------------------------------===//
+// Vectors
+//===----------------------------------------------------------------------===//
+
+// @Vector(N, T). Lanes of a byte-multiple width sit at T's size apart;
+// narrower ones (bool, u3) are bit-packed, as LLVM stores <N x i1>.
+// The lane count and encoding come from the type name, since a packed
+// vector's element type still reports a whole byte.
+struct VectorLayout {
+    enum class Lane { Signed, Unsigned, Float, Bool, Pointer, Other };
+
+    bool valid = false;
+    Lane lane = Lane::Other;
+    uint64_t lanes = 0;
+    uint64_t lane_bits = 0;      // significant bits per lane
+    uint64_t stride_bits = 0;    // distance between lanes
+};
+
+static VectorLayout ClassifyVector(SBType type) {
+    VectorLayout layout;
+    const char* name = type.GetName();
+    unsigned long long lanes = 0;
+    char element[64] = {0};
+    if (!name || sscanf(name, "@Vector(%llu, %63[^)])", &lanes, element) != 2 || lanes == 0) return layout;
+    layout.lanes = lanes;
+    uint64_t size = type.GetByteSize();
+    unsigned bits = 0;
+    if (strcmp(element, "bool") == 0) {
+        layout.lane = VectorLayout::Lane::Bool;
+        layout.lane_bits = 1;
+    } else if (element[0] == '*' || strcmp(element, "usize") == 0 || strcmp(element, "isize") == 0) {
+        layout.lane = element[0] == 'i' ? VectorLayout::Lane::Signed
+                    : element[0] == 'u' ? VectorLayout::Lane::Unsigned : VectorLayout::Lane::Pointer;
+        layout.lane_bits = size * 8 / lanes;
+    } else if ((element[0] == 'i' || element[0] == 'u' || element[0] == 'f') && sscanf(element + 1, "%u", &bits) == 1) {
+        layout.lane = element[0] == 'i' ? VectorLayout::Lane::Signed
+                    : element[0] == 'u' ? VectorLayout::Lane::Unsigned : VectorLayout::Lane::Float;
+        layout.lane_bits = bits;
+        // f80 and f128 lanes (like i128) are shown as raw bits
+        if (layout.lane == VectorLayout::Lane::Float && bits != 16 && bits != 32 && bits != 64) {
+            layout.lane = VectorLayout::Lane::Other;
+        }
+    } else {
+        layout.lane_bits = size * 8 / lanes;
+    }
+    if (layout.lane_bits == 0) return layout;
+    if (layout.lane_bits > 64) layout.lane = VectorLayout::Lane::Other;
+    if (layout.lane_bits % 8 == 0) {
+        // Padded to the element's ABI size (3-byte ints take 4)
+        layout.stride_bits = std::max<uint64_t>(layout.lane_bits, size * 8 / lanes);
+    } else {
+        layout.stride_bits = layout.lane_bits;
+    }
+    layout.valid = layout.stride_bits * lanes <= size * 8;
+    return layout;
+}
+
+static TypeLayoutCache<VectorLayout> g_vector_layouts;
+
+// `bits` bits starting at bit `offset`, little-endian, up to 64
+static uint64_t LoadBits(const uint8_t* bytes, uint64_t offset, uint64_t bits) {
+    uint64_t result = 0;
+    for (uint64_t i = 0; i < bits; i++) {
+        uint64_t bit = offset + i;
+        result |= (uint64_t)((bytes[bit / 8] >> (bit % 8)) & 1) << i;
+    }
+    return result;
+}
+
+static double HalfToDouble(uint16_t half) {
+    int exponent = (half >> 10) & 0x1f;
+    double mantissa = half & 0x3ff;
+    double value = exponent == 0    ? ldexp(mantissa, -24)
+                 : exponent == 0x1f ? (mantissa ? NAN : INFINITY)
+                                    : ldexp(mantissa + 1024, exponent - 25);
+    return (half & 0x8000) ? -value : value;
+}
+
+// One lane in its element's encoding, or as hex
+static std::string VectorLaneText(const uint8_t* bytes, const VectorLayout& layout, uint64_t lane, bool hex) {
+    char buf[64];
+    uint64_t offset = lane * layout.stride_bits;
+    if (layout.lane_bits > 64) {
+        // Wide lanes are byte-aligned; most significant byte first
+        std::string text = "0x";
+        for (uint64_t i = layout.lane_bits / 8; i-- > 0;) {
+            snprintf(buf, sizeof(buf), "%02x", bytes[offset / 8 + i]);
+            text += buf;
+        }
+        return text;
+    }
+    uint64_t raw = LoadBits(bytes, offset, layout.lane_bits);
+    if (hex || layout.lane == VectorLayout::Lane::Pointer || layout.lane == VectorLayout::Lane::Other) {
+        snprintf(buf, sizeof(buf), "0x%llx", (unsigned long long)raw);
+        return buf;
+    }
+    switch (layout.lane) {
+    case VectorLayout::Lane::Bool:
+        return raw ? "true" : "false";
+    case VectorLayout::Lane::Signed: {
+        uint64_t sign = 1ull << (layout.lane_bits - 1);
+        int64_t value = layout.lane_bits == 64 ? (int64_t)raw : (int64_t)((raw ^ sign) - sign);
+        snprintf(buf, sizeof(buf), "%lld", (long long)value);
+        return buf;
+    }
+    case VectorLayout::Lane::Float: {
+        double value;
+        if (layout.lane_bits == 16) {
+            value = HalfToDouble((uint16_t)raw);
+        } else if (layout.lane_bits == 32) {
+            uint32_t word = (uint32_t)raw;
+            float f;
+            memcpy(&f, &word, sizeof(f));
+            value = f;
+        } else {
+            memcpy(&value, &raw, sizeof(value));
+        }
+        snprintf(buf, sizeof(buf), "%g", value);
+        return buf;
+    }
+    default:
+        snprintf(buf, sizeof(buf), "%llu", (unsigned long long)raw);
+        return buf;
+    }
+}
+
+//===----------------------------------------------------------------------===//
+// Packed Structs
+//===----------------------------------------------------------------------===//
+
+// packed struct fields are bitfields of the backing integer. Offsets,
+// widths and encodings are worked out once per type, so a render is one
+// read of the value plus shifts and masks. Some compilers describe the
+// type as just its backing integer; a same-named definition with the
+// fields is looked up in the target for those.
+struct PackedStructLayout {
+    enum class Kind { Unsigned, Signed, Bool, Enum, Packed, Other };
+
+    struct Field {
+        std::string name;
+        uint64_t bit_offset = 0;
+        uint64_t bit_width = 0;
+        Kind kind = Kind::Unsigned;
+        std::vector<std::pair<int64_t, std::string>> tags;   // enums, by value
+        SBType type;                                          // nested packed structs
+    };
+
+    bool valid = false;
+    std::vector<Field> fields;
+};
+
+static PackedStructLayout ClassifyPackedStructType(SBType type) {
+    PackedStructLayout layout;
+    type = type.GetCanonicalType();
+    bool any_bitfield = false;
+    for (uint32_t i = 0; i < type.GetNumberOfFields(); i++) {
+        SBTypeMember member = type.GetFieldAtIndex(i);
+        SBType field_type = member.GetType().GetCanonicalType();
+        PackedStructLayout::Field field;
+        field.name = member.GetName() ? member.GetName() : "?";
+        field.bit_offset = member.GetOffsetInBits();
+        field.bit_width = member.IsBitfield() ? member.GetBitfieldSizeInBits() : field_type.GetByteSize() * 8;
+        any_bitfield = any_bitfield || member.IsBitfield();
+
+        const char* name = field_type.GetName();
+        unsigned bits = 0;
+        if (field_type.GetTypeClass() == eTypeClassEnumeration) {
+            field.kind = PackedStructLayout::Kind::Enum;
+            SBTypeEnumMemberList members = field_type.GetEnumMembers();
+            for (uint32_t m = 0; m < members.GetSize(); m++) {
+                SBTypeEnumMember tag = members.GetTypeEnumMemberAtIndex(m);
+                field.tags.push_back({tag.GetValueAsSigned(), tag.GetName() ? tag.GetName() : "?"});
+            }
+        } else if (field_type.GetNumberOfFields() > 0) {
+            field.kind = PackedStructLayout::Kind::Packed;
+            field.type = field_type;
+        } else if (name && strcmp(name, "bool") == 0) {
+            field.kind = PackedStructLayout::Kind::Bool;
+        } else if (name && name[0] == 'i' && sscanf(name + 1, "%u", &bits) == 1) {
+            field.kind = PackedStructLayout::Kind::Signed;
+        } else if (field_type.GetBasicType() == eBasicTypeInt) {
+            field.kind = PackedStructLayout::Kind::Signed;
+        } else if (field_type.GetTypeClass() != eTypeClassBuiltin) {
+            field.kind = PackedStructLayout::Kind::Other;
+        }
+        layout.fields.push_back(std::move(field));
+    }
+    layout.valid = any_bitfield;
+    return layout;
+}
+
+static PackedStructLayout ClassifyPackedStruct(TargetType source) {
+    PackedStructLayout layout = ClassifyPackedStructType(source.type);
+    SBType canonical = source.type.GetCanonicalType();
+    const char* name = source.type.GetName();
+    if (layout.valid || canonical.GetNumberOfFields() > 0 || canonical.GetTypeClass() == eTypeClassEnumeration || !name) {
+        return layout;
+    }
+    SBTypeList candidates = source.target.FindTypes(name);
+    for (uint32_t i = 0; i < candidates.GetSize(); i++) {
+        SBType candidate = candidates.GetTypeAtIndex(i);
+        if (candidate.GetByteSize() != source.type.GetByteSize()) continue;
+        layout = ClassifyPackedStructType(candidate);
+        if (layout.valid) break;
+    }
+    return layout;
+}
+
+static TypeLayoutCache<PackedStructLayout> g_packed_struct_layouts;
+
+// .{ .flags = 0b101, .kind = .read, .len = 12 } from the backing bytes.
+// Unsigned fields narrower than a byte print in binary, padded to their
+// width, so the bit pattern reads directly.
+static void PrintPackedFields(SBTarget target, const uint8_t* bytes, size_t size, uint64_t base,
+                              const PackedStructLayout& layout, SBStream& stream) {
+    stream.Printf(".{");
+    for (size_t i = 0; i < layout.fields.size(); i++) {
+        const PackedStructLayout::Field& field = layout.fields[i];
+        stream.Printf("%s.%s = ", i > 0 ? ", " : " ", field.name.c_str());
+        uint64_t offset = base + field.bit_offset;
+        if (field.bit_width == 0 || field.bit_width > 64 || (offset + field.bit_width + 7) / 8 > size) {
+            stream.Printf("...");
+            continue;
+        }
+        if (field.kind == PackedStructLayout::Kind::Packed) {
+            const PackedStructLayout& nested = g_packed_struct_layouts.Get(TargetType{target, field.type}, ClassifyPackedStruct);
+            if (nested.valid) {
+                PrintPackedFields(target, bytes, size, offset, nested, stream);
+                continue;
+            }
+        }
+        uint64_t raw = LoadBits(bytes, offset, field.bit_width);
+        uint64_t sign = 1ull << (field.bit_width - 1);
+        int64_t signed_value = field.bit_width == 64 ? (int64_t)raw : (int64_t)((raw ^ sign) - sign);
+        switch (field.kind) {
+        case PackedStructLayout::Kind::Bool:
+            stream.Printf(raw ? "true" : "false");
+            break;
+        case PackedStructLayout::Kind::Signed:
+            stream.Printf("%lld", (long long)signed_value);
+            break;
+        case PackedStructLayout::Kind::Enum: {
+            auto tag = std::find_if(field.tags.begin(), field.tags.end(), [&](const std::pair<int64_t, std::string>& t) {
+                return (uint64_t)t.first == raw || t.first == signed_value;
+            });
+            if (tag != field.tags.end()) {
+                stream.Printf(".%s", tag->second.c_str());
+            } else {
+                stream.Printf("@enumFromInt(%llu)", (unsigned long long)raw);
+            }
+            break;
+        }
+        case PackedStructLayout::Kind::Unsigned:
+            if (field.bit_width > 1 && field.bit_width < 8) {
+                char digits[8];
+                for (uint64_t b = 0; b < field.bit_width; b++) digits[b] = (raw >> (field.bit_width - 1 - b)) & 1 ? '1' : '0';
+                digits[field.bit_width] = '\0';
+                stream.Printf("0b%s", digits);
+            } else {
+                stream.Printf("%llu", (unsigned long long)raw);
+            }
+            break;
+        default:
+            stream.Printf("0x%llx", (unsigned long long)raw);
+            break;
+        }
+    }
+    stream.Printf(layout.fields.empty() ? "}" : " }");
+}
+
+//===----------------------------------------------------------------------===//
+// Map Lookup Dispatch
+//===----------------------------------------------------------------------===//
+
+static bool IsZigHashMap(SBValue value) {
+    if (IsZigArrayHashMap(value)) return true;
+    const char* name = ResolveHashMapUnmanaged(value).GetTypeName();
+    return name && strncmp(name, "hash_map.", 9) == 0;
+}
+
+// map.get(key) for std.HashMap and std.ArrayHashMap values; reports
+// errors via `error`
+static bool ZigHashMapGet(SBValue value, const std::string& key_text, HashMapLookup& lookup,
+                          SBType& value_type, std::string& error) {
+    if (IsZigArrayHashMap(value)) {
+        return ZigArrayHashMapGet(value, key_text, lookup, value_type, error);
+    }
+    SBValue map = ResolveHashMapUnmanaged(value);
+    const HashMapLayout& layout = g_hash_map_layouts.Get(map, ClassifyHashMap);
+    HashMapState state;
+    if (!ReadHashMapState(map, layout, state)) {
+        error = "error: not a std.HashMap (or its header is unreadable)";
+        return false;
+    }
+    if (layout.key_size == 0) {
+        error = "error: key/value types not found in debug info";
+        return false;
+    }
+    if (!HashMapContextSupported(map, "hash_map", error)) return false;
+    HashMapKey key;
+    if (!EncodeHashMapKey(layout.key_type, layout.key_size, key_text, key, error)) return false;
+    if (!LookupHashMap(map.GetProcess(), layout, state, key, lookup)) {
+        error = "error: failed to read map memory";
+        return false;
+    }
+    value_type = layout.value_type;
+    return true;
+}
+
+//===----------------------------------------------------------------------===//
+// Formatter Callbacks
+//===----------------------------------------------------------------------===//
+
+static bool ZigSliceSummary(SBValue value, SBTypeSummaryOptions options, SBStream &stream) {
+    SBValue len = value.GetChildMemberWithName("len");
+    SBValue ptr = value.GetChildMemberWithName("ptr");
+    if (len.IsValid() && ptr.IsValid()) {
+        stream.Printf("len=%llu ptr=0x%llx",
+            (unsigned long long)len.GetValueAsUnsigned(0),
+            (unsigned long long)ptr.GetValueAsUnsigned(0));
+        return true;
+    }
+    return false;
+}
+
+static bool ZigStringSummary(SBValue value, SBTypeSummaryOptions options, SBStream &stream) {
+    SBValue len = value.GetChildMemberWithName("len");
+    SBValue ptr = value.GetChildMemberWithName("ptr");
+    if (!len.IsValid() || !ptr.IsValid()) return false;
+
+    uint64_t len_val = len.GetValueAsUnsigned(0);
+    uint64_t ptr_val = ptr.GetValueAsUnsigned(0);
+
+    // Use stack buffer to avoid heap allocation on every render
+    static constexpr size_t kMaxStringLen = 1024;
+    if (len_val > 0 && len_val <= kMaxStringLen && ptr_val != 0) {
+        SBProcess process = value.GetProcess();
+        if (process.IsValid()) {
+            char buffer[kMaxStringLen + 1];
+            SBError error;
+            size_t to_read = len_val < kMaxStringLen ? len_val : kMaxStringLen;
+            size_t bytes_read = process.ReadMemory(ptr_val, buffer, to_read, error);
+            if (bytes_read > 0 && error.Success()) {
+                buffer[bytes_read] = '\0';
+                stream.Printf("\"%s\"", buffer);
+                if (len_val > kMaxStringLen) {
+                    stream.Printf("... (%llu bytes)", (unsigned long long)len_val);
+                }
+                return true;
+            }
+        }
+    }
+    stream.Printf("len=%llu ptr=0x%llx", (unsigned long long)len_val, (unsigned long long)ptr_val);
+    return true;
+}
+
+static bool ZigOptionalSummary(SBValue value, SBTypeSummaryOptions options, SBStream &stream) {
+    const OptionalLayout& layout = GetOptionalLayout(value);
+    OptionalState state = DecodeOptional(value, layout);
+    if (state == OptionalState::Null) {
+        stream.Printf("null");
+        return true;
+    }
+    if (state == OptionalState::Unknown) {
+        // Unrecognized layout - be conservative, don't dereference
+        stream.Printf("?");
+        return true;
+    }
+
+    switch (layout.encoding) {
+    case OptionalEncoding::Flag: {
+        // Has value - show the data field
+        SBValue data = value.GetChildMemberWithName("data");
+        if (data.IsValid()) {
+            const char* summary = data.GetSummary();
+            if (summary && summary[0]) {
+                stream.Printf("%s", summary);
+                return true;
+            }
+            const char* val = data.GetValue();
+            if (val && val[0]) {
+                stream.Printf("%s", val);
+                return true;
+            }
+        }
+        stream.Printf("(has value)");
+        return true;
+    }
+    case OptionalEncoding::NullPointer: {
+        // Don't try to dereference - just show the pointer value
+        uint8_t bytes[8];
+        ReadValueBytes(value, layout.word_offset, bytes, layout.word_size);
+        stream.Printf("0x%llx", (unsigned long long)LoadUnsigned(bytes, layout.word_size));
+        return true;
+    }
+    case OptionalEncoding::NullSlicePtr: {
+        // The payload is the slice itself
+        const char* type_name = value.GetTypeName();
+        if (type_name && (strcmp(type_name, "?[]u8") == 0 || strcmp(type_name, "?[]const u8") == 0)) {
+            return ZigStringSummary(value, options, stream);
+        }
+        return ZigSliceSummary(value, options, stream);
+    }
+    case OptionalEncoding::ErrorSetZero: {
+        // The payload is the error value itself, named by its enumerator
+        const char* val = value.GetValue();
+        if (val && val[0]) {
+            stream.Printf(strncmp(val, "error.", 6) == 0 ? "%s" : "error.%s", val);
+            return true;
+        }
+        break;
+    }
+    case OptionalEncoding::Unknown:
+        break;
+    }
+    stream.Printf("(has value)");
+    return true;
+}
+
+static bool ZigErrorUnionSummary(SBValue value, SBTypeSummaryOptions options, SBStream &stream) {
+    // Zig error unions have 'tag' (error code, 0 = success) and 'value' (payload) fields
+    SBValue tag = value.GetChildMemberWithName("tag");
+    if (!tag.IsValid()) {
+        // Fallback: try older field names
+        tag = value.GetChildMemberWithName("error");
+        if (!tag.IsValid()) tag = value.GetChildMemberWithName("err");
+    }
+    if (!tag.IsValid()) return false;
+
+    uint64_t tag_val = tag.GetValueAsUnsigned(0);
+    if (tag_val != 0) {
+        // Error case - show error name if available
+        const char* error_name = tag.GetValue();
+        if (error_name) {
+            stream.Printf("error.%s", error_name);
+        } else {
+            stream.Printf("error(%llu)", (unsigned long long)tag_val);
+        }
+        return true;
+    }
+
+    // Success case - show payload
+    SBValue payload = value.GetChildMemberWithName("value");
+    if (payload.IsValid()) {
+        const char* summary = payload.GetSummary();
+        if (summary && summary[0]) {
+            stream.Printf("%s", summary);
+            return true;
+        }
+        const char* val = payload.GetValue();
+        if (val && val[0]) {
+            stream.Printf("%s", val);
+            return true;
+        }
+    }
+    stream.Printf("(success)");
+    return true;
+}
+
+static bool ZigTaggedUnionSummary(SBValue value, SBTypeSummaryOptions options, SBStream &stream) {
+    SBValue tag = value.GetChildMemberWithName("tag");
+    if (!tag.IsValid()) return false;
+
+    const char* tag_val = tag.GetValue();
+    if (!tag_val) return false;
+
+    stream.Printf(".%s", tag_val);
+
+    // Try to show active payload
+    SBValue payload = value.GetChildMemberWithName("payload");
+    if (payload.IsValid()) {
+        SBValue active = payload.GetChildMemberWithName(tag_val);
+        if (active.IsValid()) {
+            const char* summary = active.GetSummary();
+            if (summary && summary[0]) {
+                stream.Printf(" = %s", summary);
+            }
+        }
+    }
+    return true;
+}
+
+static bool ZigArrayListSummary(SBValue value, SBTypeSummaryOptions options, SBStream &stream) {
+    SBValue items = value.GetChildMemberWithName("items");
+    SBValue capacity = value.GetChildMemberWithName("capacity");
+
+    if (items.IsValid()) {
+        SBValue len = items.GetChildMemberWithName("len");
+        if (len.IsValid()) {
+            stream.Printf("len=%llu", (unsigned long long)len.GetValueAsUnsigned(0));
+            if (capacity.IsValid()) {
+                stream.Printf(" capacity=%llu", (unsigned long long)capacity.GetValueAsUnsigned(0));
+            }
+            return true;
+        }
+    }
+    stream.Printf("(ArrayList)");
+    return true;
+}
+
+// Summaries scan the metadata only up to this capacity; `zig map-stats`
+// has no limit
+static constexpr uint64_t kSummaryScanSlots = 1 << 20;
+
+static bool ZigHashMapSummary(SBValue value, SBTypeSummaryOptions options, SBStream &stream) {
+    SBValue map = ResolveHashMapUnmanaged(value);
+    HashMapState state;
+    if (!ReadHashMapState(map, g_hash_map_layouts.Get(map, ClassifyHashMap), state)) {
+        SBValue size = value.GetChildMemberWithName("size");
+        if (!size.IsValid()) size = value.GetChildMemberWithName("count");
+        if (size.IsValid()) {
+            stream.Printf("size=%llu", (unsigned long long)size.GetValueAsUnsigned(0));
+            return true;
+        }
+        stream.Printf("(HashMap)");
+        return true;
+    }
+
+    stream.Printf("size=%llu", (unsigned long long)state.size);
+    if (state.metadata == 0) return true;
+
+    stream.Printf(" capacity=%llu load=%.1f%%", (unsigned long long)state.capacity,
+        100.0 * (double)state.size / (double)state.capacity);
+
+    zdb::HashMapSlotStats stats;
+    if (state.capacity <= kSummaryScanSlots && ScanHashMap(value.GetProcess(), state, stats)) {
+        stream.Printf(" tombstones=%llu longest_probe=%llu",
+            (unsigned long long)stats.tombstones, (unsigned long long)stats.longest_run);
+    }
+    return true;
+}
+
+static constexpr uint64_t kArrayHashMapPreview = 4;
+
+// size plus the first entries in insertion order, one read per column
+static bool ZigArrayHashMapSummary(SBValue value, SBTypeSummaryOptions options, SBStream &stream) {
+    ArrayHashMapView view;
+    if (!GetArrayHashMapView(value, view)) {
+        stream.Printf("(ArrayHashMap)");
+        return true;
+    }
+    stream.Printf("size=%llu", (unsigned long long)view.state.len);
+    if (view.state.len == 0) return true;
+
+    SBProcess process = value.GetProcess();
+    SBTarget target = value.GetTarget();
+    uint64_t count = std::min(view.state.len, kArrayHashMapPreview);
+    std::vector<uint8_t> keys, values;
+    if (!ReadMultiArrayListColumn(process, view.state, *view.keys, 0, count, keys)) return true;
+    if (view.values && !ReadMultiArrayListColumn(process, view.state, *view.values, 0, count, values)) {
+        return true;
+    }
+
+    stream.Printf(" { ");
+    for (uint64_t i = 0; i < count; i++) {
+        if (i > 0) stream.Printf(", ");
+        SBValue key = MakeValueFromBytes(target, "key", keys.data() + i * view.keys->size,
+            view.keys->size, view.keys->type);
+        if (view.values && view.values->size > 0) {
+            SBValue val = MakeValueFromBytes(target, "value", values.data() + i * view.values->size,
+                view.values->size, view.values->type);
+            stream.Printf("%s = %s", ValueText(key).c_str(), ValueText(val).c_str());
+        } else {
+            stream.Printf("%s", ValueText(key).c_str());
+        }
+    }
+    stream.Printf(view.state.len > count ? ", ... }" : " }");
+    return true;
+}
+
+static bool ZigBoundedArraySummary(SBValue value, SBTypeSummaryOptions options, SBStream &stream) {
+    SBValue len = value.GetChildMemberWithName("len");
+    if (len.IsValid()) {
+        stream.Printf("len=%llu", (unsigned long long)len.GetValueAsUnsigned(0));
+        return true;
+    }
+    stream.Printf("(BoundedArray)");
+    return true;
+}
+
+static bool ZigMultiArrayListSummary(SBValue value, SBTypeSummaryOptions options, SBStream &stream) {
+    SBValue len = value.GetChildMemberWithName("len");
+    SBValue capacity = value.GetChildMemberWithName("capacity");
+    if (len.IsValid()) {
+        stream.Printf("len=%llu", (unsigned long long)len.GetValueAsUnsigned(0));
+        if (capacity.IsValid()) {
+            stream.Printf(" capacity=%llu", (unsigned long long)capacity.GetValueAsUnsigned(0));
+        }
+        // Column names, so `zig column` / items(.field) targets are visible
+        const MultiArrayListLayout& layout = g_multi_array_list_layouts.Get(value, ClassifyMultiArrayList);
+        for (size_t i = 0; i < layout.columns.size(); i++) {
+            stream.Printf("%s.%s", i == 0 ? " fields=" : ",", layout.columns[i].name.c_str());
+        }
+        return true;
+    }
+    stream.Printf("(MultiArrayList)");
+    return true;
+}
+
+static constexpr uint64_t kSegmentedListPreview = 4;
+
+// len plus the first elements, one read per shelf they span
+static bool ZigSegmentedListSummary(SBValue value, SBTypeSummaryOptions options, SBStream &stream) {
+    const SegmentedListLayout& layout = g_segmented_list_layouts.Get(value.GetType(), ClassifySegmentedList);
+    SegmentedListState state;
+    if (!ReadSegmentedListState(value, layout, state)) {
+        SBValue len = value.GetChildMemberWithName("len");
+        if (len.IsValid()) {
+            stream.Printf("len=%llu", (unsigned long long)len.GetValueAsUnsigned(0));
+            return true;
+        }
+        stream.Printf("(SegmentedList)");
+        return true;
+    }
+    stream.Printf("len=%llu", (unsigned long long)state.len);
+    if (state.len == 0) return true;
+
+    uint64_t count = std::min(state.len, kSegmentedListPreview);
+    std::vector<uint8_t> elements;
+    if (!ReadSegmentedListPrefix(value, layout, state, count, elements)) return true;
+    SBTarget target = value.GetTarget();
+    stream.Printf(" [");
+    for (uint64_t i = 0; i < count; i++) {
+        SBValue element = MakeValueFromBytes(target, "element", elements.data() + i * layout.element_size,
+            layout.element_size, layout.element_type);
+        stream.Printf("%s%s", i > 0 ? ", " : "", ValueText(element).c_str());
+    }
+    stream.Printf(state.len > count ? ", ...]" : "]");
+    return true;
+}
+
+static constexpr uint64_t kLinkedListPreview = 4;
+static constexpr uint64_t kSummaryNodeBudget = 10000;
+
+// Node count (bounded) plus the first payloads; a corrupted list reports
+// its cycle instead of hanging
+static bool ZigLinkedListSummary(SBValue value, SBTypeSummaryOptions options, SBStream &stream) {
+    const LinkedListLayout* layout = nullptr;
+    uint64_t first = 0;
+    if (!LinkedListStart(value, layout, first)) {
+        stream.Printf("(LinkedList)");
+        return true;
+    }
+    SBProcess process = value.GetProcess();
+    LinkedListWalk walk;
+    WalkLinkedList(process, *layout, first, kSummaryNodeBudget, kLinkedListPreview, walk);
+
+    switch (walk.outcome) {
+    case LinkedListWalk::Outcome::End:
+        stream.Printf("len=%llu", (unsigned long long)walk.count);
+        break;
+    case LinkedListWalk::Outcome::Cycle:
+        stream.Printf("cycle at [%llu] (length %llu)",
+            (unsigned long long)walk.cycle_start, (unsigned long long)walk.cycle_length);
+        break;
+    case LinkedListWalk::Outcome::Budget:
+        stream.Printf("len>%llu", (unsigned long long)kSummaryNodeBudget);
+        break;
+    case LinkedListWalk::Outcome::ReadError:
+        stream.Printf("len>=%llu (unreadable node)", (unsigned long long)walk.count);
+        break;
+    }
+    if (!layout->has_data || walk.nodes.empty()) return true;
+
+    SBTarget target = value.GetTarget();
+    stream.Printf(" [");
+    for (size_t i = 0; i < walk.nodes.size(); i++) {
+        stream.Printf("%s%s", i > 0 ? ", " : "", LinkedListNodeText(process, target, *layout, walk.nodes[i]).c_str());
+    }
+    stream.Printf(walk.count > walk.nodes.size() ? ", ...]" : "]");
+    return true;
+}
+
+static constexpr size_t kBitSetPreview = 8;
+// Summaries count bits only up to this length (a 128 KiB read) and show
+// the count past it as a lower bound; `zig bits` has no limit
+static constexpr uint64_t kSummaryScanBits = 1ull << 20;
+
+// Length, population count and the first set indices
+static bool ZigBitSetSummary(SBValue value, SBTypeSummaryOptions options, SBStream &stream) {
+    uint64_t nbits = 0;
+    std::vector<uint8_t> bytes;
+    std::string error;
+    if (!ReadBitSet(value, kSummaryScanBits, nbits, bytes, error)) {
+        if (nbits > 0) {
+            stream.Printf("bits=%llu", (unsigned long long)nbits);
+        } else {
+            stream.Printf("(BitSet)");
+        }
+        return true;
+    }
+    uint64_t scanned = std::min(nbits, kSummaryScanBits);
+    bool partial = scanned < nbits;
+    uint64_t set = zdb::PopCountBits(bytes.data(), scanned);
+    stream.Printf("bits=%llu set%s%llu", (unsigned long long)nbits, partial ? ">=" : "=",
+                  (unsigned long long)set);
+    if (set == 0) return true;
+
+    std::vector<uint64_t> indices;
+    zdb::FindSetBits(bytes.data(), scanned, 0, kBitSetPreview, indices);
+    stream.Printf(" {");
+    for (size_t i = 0; i < indices.size(); i++) {
+        stream.Printf("%s%llu", i > 0 ? ", " : "", (unsigned long long)indices[i]);
+    }
+    stream.Printf(partial || set > indices.size() ? ", ...}" : "}");
+    return true;
+}
+
+static constexpr uint64_t kRingBufferPreview = 4;
+
+// Queued elements in logical order, across the wraparound
+static bool ZigRingBufferSummary(SBValue value, SBTypeSummaryOptions options, SBStream &stream) {
+    const RingBufferLayout& layout = g_ring_buffer_layouts.Get(value.GetType(), ClassifyRingBuffer);
+    RingBufferState state;
+    if (!ReadRingBufferState(value, layout, state)) {
+        stream.Printf("(ring buffer)");
+        return true;
+    }
+    stream.Printf("len=%llu capacity=%llu", (unsigned long long)state.count, (unsigned long long)state.capacity);
+    if (state.count == 0) return true;
+
+    uint64_t count = std::min(state.count, kRingBufferPreview);
+    std::vector<uint8_t> elements;
+    if (!ReadRingBufferPrefix(value, layout, state, count, elements)) return true;
+    SBTarget target = value.GetTarget();
+    stream.Printf(" [");
+    for (uint64_t i = 0; i < count; i++) {
+        SBValue element = MakeValueFromBytes(target, "element", elements.data() + i * layout.element_size,
+            layout.element_size, layout.element_type);
+        stream.Printf("%s%s", i > 0 ? ", " : "", ValueText(element).c_str());
+    }
+    stream.Printf(state.count > count ? ", ...]" : "]");
+    return true;
+}
+
+// Count, capacity and the element at items[0]: the top of a PriorityQueue,
+// the minimum of a PriorityDequeue
+static bool ZigPriorityQueueSummary(SBValue value, SBTypeSummaryOptions options, SBStream &stream) {
+    const PriorityQueueLayout& layout = g_priority_queue_layouts.Get(value.GetType(), ClassifyPriorityQueue);
+    PriorityQueueState state;
+    if (!ReadPriorityQueueState(value, layout, state)) {
+        stream.Printf("(PriorityQueue)");
+        return true;
+    }
+    stream.Printf("len=%llu capacity=%llu", (unsigned long long)state.count, (unsigned long long)state.capacity);
+    if (state.count == 0) return true;
+
+    std::vector<uint8_t> first;
+    if (!ReadTargetMemory(value.GetProcess(), state.items, layout.element_size, first)) return true;
+    SBValue element = MakeValueFromBytes(value.GetTarget(), "top", first.data(), first.size(), layout.element_type);
+    stream.Printf(" %s=%s", layout.dequeue ? "min" : "top", ValueText(element).c_str());
+    return true;
+}
+
+static constexpr uint64_t kTreapPreview = 4;
+
+static std::string TreapKeyText(SBTarget target, const TreapLayout& layout, const TreapNode& node) {
+    return ValueText(MakeValueFromBytes(target, "key", node.bytes.data() + layout.key_offset,
+        layout.key_size, layout.key_type));
+}
+
+// Size and height (bounded), plus the smallest keys
+static bool ZigTreapSummary(SBValue value, SBTypeSummaryOptions options, SBStream &stream) {
+    const TreapLayout& layout = g_treap_layouts.Get(value.GetType(), ClassifyTreap);
+    uint8_t word[8];
+    if (!layout.valid || !ReadValueBytes(value, layout.root_offset, word, layout.word_size)) {
+        stream.Printf("(Treap)");
+        return true;
+    }
+    uint64_t root = LoadUnsigned(word, layout.word_size);
+    SBProcess process = value.GetProcess();
+    TreapStats stats = MeasureTreap(process, layout, root, kSummaryNodeBudget);
+    stream.Printf(stats.complete ? "size=%llu depth=%llu" : "size>=%llu depth>=%llu",
+        (unsigned long long)stats.size, (unsigned long long)stats.depth);
+    if (stats.size == 0) return true;
+
+    std::vector<TreapNode> nodes;
+    bool more = false;
+    WalkTreapInOrder(process, layout, root, nullptr, kTreapPreview, kSummaryNodeBudget, nodes, more);
+    SBTarget target = value.GetTarget();
+    stream.Printf(" {");
+    for (size_t i = 0; i < nodes.size(); i++) {
+        stream.Printf("%s%s", i > 0 ? ", " : "", TreapKeyText(target, layout, nodes[i]).c_str());
+    }
+    stream.Printf(more ? ", ...}" : "}");
+    return true;
+}
+
+static constexpr uint64_t kEnumContainerPreview = 16;
+
+// .{ .red = 1, .blue = 3 } for arrays and maps (present keys only),
+// .{ .red, .blue } for sets; decoded from the value's own data
+static bool ZigEnumContainerSummary(SBValue value, SBTypeSummaryOptions options, SBStream &stream) {
+    const EnumContainerLayout& layout = g_enum_container_layouts.Get(value, ClassifyEnumContainer);
+    std::vector<uint8_t> values(layout.count * layout.value_size);
+    std::vector<uint8_t> bits((layout.count + 7) / 8);
+    if (!layout.valid ||
+        (layout.has_values && !ReadValueBytes(value, layout.values_offset, values.data(), values.size())) ||
+        (layout.has_bits && !ReadValueBytes(value, layout.bits_offset, bits.data(), bits.size()))) {
+        stream.Printf("(enum container)");
+        return true;
+    }
+
+    SBTarget target = value.GetTarget();
+    uint64_t shown = 0;
+    stream.Printf(".{");
+    for (uint64_t i = 0; i < layout.count; i++) {
+        if (layout.has_bits && !((bits[i / 8] >> (i % 8)) & 1)) continue;
+        if (shown == kEnumContainerPreview) {
+            stream.Printf(", ...");
+            break;
+        }
+        stream.Printf(shown++ ? ", " : " ");
+        if (i < layout.names.size()) {
+            stream.Printf(".%s", layout.names[i].c_str());
+        } else {
+            stream.Printf("[%llu]", (unsigned long long)i);
+        }
+        if (layout.has_values) {
+            SBValue element = MakeValueFromBytes(target, "value", values.data() + i * layout.value_size,
+                layout.value_size, layout.value_type);
+            stream.Printf(" = %s", ValueText(element).c_str());
+        }
+    }
+    stream.Printf(shown ? " }" : "}");
+    return true;
+}
+
+static constexpr uint64_t kJsonSummaryDepth = 4;
+static constexpr uint64_t kJsonSummaryBytes = 200;
+
+// Compact JSON, cut with "..." past a small depth and byte budget
+static bool ZigJsonValueSummary(SBValue value, SBTypeSummaryOptions options, SBStream &stream) {
+    std::string json, error;
+    if (!ZigJsonSerialize(value, kJsonSummaryDepth, kJsonSummaryBytes, json, error)) return false;
+    stream.Printf("%s", json.c_str());
+    return true;
+}
+
+// Thread.Pool { mutex, cond, run_queue, is_running, allocator, threads, ids }:
+// worker count, queued runnables (bounded walk of run_queue) and shutdown
+static bool ZigThreadPoolSummary(SBValue value, SBTypeSummaryOptions options, SBStream &stream) {
+    SBValue run_queue = value.GetChildMemberWithName("run_queue");
+    SBValue is_running = value.GetChildMemberWithName("is_running");
+    const LinkedListLayout* layout = nullptr;
+    uint64_t first = 0;
+    if (!run_queue.IsValid() || !is_running.IsValid() || !LinkedListStart(run_queue, layout, first)) return false;
+
+    // Single-threaded builds have no threads slice
+    SBValue threads = value.GetChildMemberWithName("threads").GetChildMemberWithName("len");
+    stream.Printf("threads=%llu ", (unsigned long long)(threads.IsValid() ? threads.GetValueAsUnsigned(0) : 0));
+    LinkedListWalk walk;
+    WalkLinkedList(value.GetProcess(), *layout, first, kSummaryNodeBudget, 0, walk);
+    switch (walk.outcome) {
+    case LinkedListWalk::Outcome::End:
+        stream.Printf("queued=%llu", (unsigned long long)walk.count);
+        break;
+    case LinkedListWalk::Outcome::Cycle:
+        stream.Printf("queue: cycle at [%llu] (length %llu)",
+            (unsigned long long)walk.cycle_start, (unsigned long long)walk.cycle_length);
+        break;
+    case LinkedListWalk::Outcome::Budget:
+        stream.Printf("queued>%llu", (unsigned long long)walk.count);
+        break;
+    case LinkedListWalk::Outcome::ReadError:
+        stream.Printf("queued>=%llu (unreadable node)", (unsigned long long)walk.count);
+        break;
+    }
+    if (is_running.GetValueAsUnsigned(1) == 0) stream.Printf(" shutting down");
+    return true;
+}
+
+// Thread.WaitGroup { state: atomic usize, event }: bit 0 is set while a
+// thread waits, the rest counts pending work
+static bool ZigWaitGroupSummary(SBValue value, SBTypeSummaryOptions options, SBStream &stream) {
+    uint64_t offset;
+    SBType state_type;
+    if (!FieldPathOffset(value.GetType(), "state.raw", offset, state_type) &&
+        !FieldPathOffset(value.GetType(), "state", offset, state_type)) {
+        return false;
+    }
+    uint8_t word[8];
+    uint64_t size = state_type.GetByteSize();
+    if (size == 0 || size > 8 || !ReadValueBytes(value, offset, word, size)) return false;
+    uint64_t state = LoadUnsigned(word, size);
+    stream.Printf("pending=%llu%s", (unsigned long long)(state >> 1), (state & 1) ? " waiting" : "");
+    return true;
+}
+
+// os.linux.IoUring: submission and completion ring occupancy and the
+// kernel's dropped/overflow counters, from the shared ring words
+static bool ZigIoUringSummary(SBValue value, SBTypeSummaryOptions options, SBStream &stream) {
+    const IoUringLayout& layout = g_io_uring_layouts.Get(value.GetType(), ClassifyIoUring);
+    IoUringState state;
+    if (!ReadIoUringState(value, layout, state)) return false;
+    PrintIoUringState(state, stream);
+    return true;
+}
+
+// Interface summaries render the implementation's summary, which may itself
+// be an interface (an allocator wrapping another); bounded in case a ptr
+// leads back to itself
+static constexpr int kInterfaceNesting = 4;
+
+// "heap.arena_allocator.ArenaAllocator@0x... used=... reserved=...": the
+// implementation recovered from the vtable, and `ptr` cast to it
+static bool ZigInterfaceSummary(SBValue value, SBTypeSummaryOptions options, SBStream &stream) {
+    static thread_local int nesting = 0;
+    const InterfaceLayout& layout = g_interface_layouts.Get(value.GetType(), ClassifyInterface);
+    uint8_t word[8];
+    if (!layout.valid || !ReadValueBytes(value, layout.vtable_offset, word, layout.word_size)) return false;
+    uint64_t vtable = LoadUnsigned(word, layout.word_size);
+    if (!ReadValueBytes(value, layout.ptr_offset, word, layout.word_size)) return false;
+    uint64_t ptr = LoadUnsigned(word, layout.word_size);
+
+    SBTarget target = value.GetTarget();
+    InterfaceImpl impl = vtable ? ResolveInterfaceImpl(target, vtable, layout.word_size) : InterfaceImpl();
+    if (impl.name.empty()) {
+        stream.Printf("ptr=0x%llx vtable=0x%llx", (unsigned long long)ptr, (unsigned long long)vtable);
+        return true;
+    }
+    stream.Printf("%s", impl.name.c_str());
+    // Stateless implementations (page_allocator) leave ptr undefined
+    if (!impl.type.IsValid() || impl.type.GetByteSize() == 0) return true;
+    stream.Printf("@0x%llx", (unsigned long long)ptr);
+    if (ptr == 0 || nesting >= kInterfaceNesting) return true;
+    nesting++;
+    SBValue concrete = target.CreateValueFromAddress("impl", SBAddress(ptr, target), impl.type);
+    const char* summary = concrete.IsValid() ? concrete.GetSummary() : nullptr;
+    nesting--;
+    if (summary && summary[0]) stream.Printf(" %s", summary);
+    return true;
+}
+
+static constexpr uint64_t kVectorSummaryLanes = 64;
+
+// <1, 2, 3, 4> from one read of the vector; lanes are hex under
+// `frame variable -f x`, and bool vectors add their lane mask (lane 0 is
+// the lowest bit)
+static bool ZigVectorSummary(SBValue value, SBTypeSummaryOptions options, SBStream &stream) {
+    const VectorLayout& layout = g_vector_layouts.Get(value.GetType(), ClassifyVector);
+    std::vector<uint8_t> bytes(value.GetByteSize());
+    if (!layout.valid || bytes.empty() || !ReadValueBytes(value, 0, bytes.data(), bytes.size())) return false;
+    bool hex = value.GetFormat() == eFormatHex;
+    uint64_t shown = std::min(layout.lanes, kVectorSummaryLanes);
+    stream.Printf("<");
+    for (uint64_t i = 0; i < shown; i++) {
+        stream.Printf("%s%s", i > 0 ? ", " : "", VectorLaneText(bytes.data(), layout, i, hex).c_str());
+    }
+    stream.Printf(shown < layout.lanes ? ", ...>" : ">");
+    if (layout.lane == VectorLayout::Lane::Bool) {
+        std::string mask;
+        uint64_t set = 0;
+        for (uint64_t i = layout.lanes; i-- > 0;) {
+            bool lane = LoadBits(bytes.data(), i * layout.stride_bits, 1) != 0;
+            set += lane;
+            if (i < kVectorSummaryLanes) mask += lane ? '1' : '0';
+        }
+        stream.Printf(" mask=0b%s set=%llu", mask.c_str(), (unsigned long long)set);
+    }
+    return true;
+}
+
+static constexpr size_t kIoBufferPreview = 32;
+
+// buffered=N/capacity (P%) [seek= end=] "pending bytes..." impl=T; "full"
+// marks a buffer that can take no more (writer backpressure)
+static bool ZigIoBufferSummary(SBValue value, SBTypeSummaryOptions options, SBStream &stream) {
+    const IoBufferLayout& layout = g_io_buffer_layouts.Get(value.GetType(), ClassifyIoBuffer);
+    IoBufferState state;
+    if (!ReadIoBufferState(value, layout, state)) return false;
+    uint64_t buffered = state.Buffered();
+    stream.Printf("buffered=%llu/%llu", (unsigned long long)buffered, (unsigned long long)state.capacity);
+    if (state.capacity > 0) stream.Printf(" (%.1f%%)", 100.0 * buffered / state.capacity);
+    if (state.capacity > 0 && buffered == state.capacity) stream.Printf(" full");
+    if (layout.has_seek) stream.Printf(" seek=%llu end=%llu", (unsigned long long)state.seek, (unsigned long long)state.end);
+    std::string preview;
+    if (buffered > 0 && ReadIoBufferPreview(value, layout, state, std::min<uint64_t>(buffered, kIoBufferPreview), preview)) {
+        stream.Printf(" \"%s\"%s", EscapeZigBytes(preview).c_str(), buffered > kIoBufferPreview ? "..." : "");
+    }
+    std::string impl = layout.has_vtable ? IoImplementationFromVtable(value, layout) : layout.impl;
+    // Fixed-buffer interfaces implement themselves
+    const char* own = value.GetType().GetName();
+    if (!impl.empty() && !(own && impl == own)) stream.Printf(" impl=%s", impl.c_str());
+    return true;
+}
+
+// "used=... reserved=... buffers=N", or where the buffer walk stopped
+static void PrintArenaStats(const ArenaStats& stats, SBStream& stream) {
+    stream.Printf("used=%llu reserved=%llu ", (unsigned long long)stats.used, (unsigned long long)stats.reserved);
+    const LinkedListWalk& walk = stats.walk;
+    switch (walk.outcome) {
+    case LinkedListWalk::Outcome::End:
+        stream.Printf("buffers=%llu", (unsigned long long)walk.count);
+        break;
+    case LinkedListWalk::Outcome::Cycle:
+        stream.Printf("buffers: cycle at [%llu] (length %llu)",
+            (unsigned long long)walk.cycle_start, (unsigned long long)walk.cycle_length);
+        break;
+    case LinkedListWalk::Outcome::Budget:
+        stream.Printf("buffers>%llu", (unsigned long long)walk.count);
+        break;
+    case LinkedListWalk::Outcome::ReadError:
+        stream.Printf("buffers>=%llu (unreadable buffer)", (unsigned long long)walk.count);
+        break;
+    }
+}
+
+static bool ZigArenaAllocatorSummary(SBValue value, SBTypeSummaryOptions options, SBStream &stream) {
+    const ArenaLayout& layout = g_arena_layouts.Get(TargetType{value.GetTarget(), value.GetType()}, ClassifyArena);
+    ArenaStats stats;
+    if (!layout.valid || !ReadArenaStats(value, layout, kSummaryNodeBudget, stats)) return false;
+    PrintArenaStats(stats, stream);
+    return true;
+}
+
+static bool ZigFixedBufferAllocatorSummary(SBValue value, SBTypeSummaryOptions options, SBStream &stream) {
+    SBValue end_index = value.GetChildMemberWithName("end_index");
+    SBValue len = value.GetChildMemberWithName("buffer").GetChildMemberWithName("len");
+    if (!end_index.IsValid() || !len.IsValid()) return false;
+    uint64_t used = end_index.GetValueAsUnsigned(0);
+    uint64_t capacity = len.GetValueAsUnsigned(0);
+    stream.Printf("used=%llu capacity=%llu", (unsigned long long)used, (unsigned long long)capacity);
+    if (capacity > 0) stream.Printf(" (%.1f%%)", 100.0 * used / capacity);
+    return true;
+}
+
+// Free-list length, then the state of the pool's arena
+static bool ZigMemoryPoolSummary(SBValue value, SBTypeSummaryOptions options, SBStream &stream) {
+    const MemoryPoolLayout& layout =
+        g_memory_pool_layouts.Get(TargetType{value.GetTarget(), value.GetType()}, ClassifyMemoryPool);
+    if (!layout.valid) return false;
+    uint8_t word[8];
+    if (!ReadValueBytes(value, layout.free_list_offset, word, layout.free_nodes.word_size)) return false;
+    LinkedListWalk free_walk;
+    WalkLinkedList(value.GetProcess(), layout.free_nodes, LoadUnsigned(word, layout.free_nodes.word_size),
+                   kSummaryNodeBudget, 0, free_walk);
+    switch (free_walk.outcome) {
+    case LinkedListWalk::Outcome::End:
+        stream.Printf("free=%llu ", (unsigned long long)free_walk.count);
+        break;
+    case LinkedListWalk::Outcome::Cycle:
+        stream.Printf("free list: cycle at [%llu] (length %llu) ",
+            (unsigned long long)free_walk.cycle_start, (unsigned long long)free_walk.cycle_length);
+        break;
+    case LinkedListWalk::Outcome::Budget:
+        stream.Printf("free>%llu ", (unsigned long long)free_walk.count);
+        break;
+    case LinkedListWalk::Outcome::ReadError:
+        stream.Printf("free>=%llu (unreadable node) ", (unsigned long long)free_walk.count);
+        break;
+    }
+    ArenaStats stats;
+    if (ReadArenaStats(value, layout.arena, kSummaryNodeBudget, stats)) PrintArenaStats(stats, stream);
+    return true;
+}
+
+static constexpr uint64_t kBigIntSummaryLimbs = 1024;
+static constexpr uint64_t kBigIntSummaryDigits = 24;
+
+// Decimal (elided in the middle when long), hex up to 128 bits, bit length.
+// Past kBigIntSummaryLimbs only the top limb is read; `zig bigint` converts
+// the whole value.
+static bool ZigBigIntSummary(SBValue value, SBTypeSummaryOptions options, SBStream &stream) {
+    const BigIntLayout& layout = g_big_int_layouts.Get(value.GetType(), ClassifyBigInt);
+    BigIntHeader header;
+    if (!layout.valid || !ReadBigIntHeader(value, layout, header)) return false;
+    SBProcess process = value.GetProcess();
+    zdb::Limbs magnitude;
+    if (header.len > kBigIntSummaryLimbs) {
+        if (!ReadBigIntLimbs(process, layout, header, header.len - 1, 1, magnitude)) return false;
+        uint64_t top = magnitude.empty() ? 0 : magnitude[0];
+        uint64_t bits = (header.len - 1) * layout.limb_size * 8 + zdb::LimbsBitLength(magnitude);
+        stream.Printf("%s0x%llx... (%llu bits)", header.negative ? "-" : "",
+            (unsigned long long)top, (unsigned long long)bits);
+        return true;
+    }
+    if (!ReadBigIntLimbs(process, layout, header, 0, header.len, magnitude)) return false;
+    uint64_t bits = zdb::LimbsBitLength(magnitude);
+    std::string decimal = ElideDigits(g_decimal_converter.ToDecimal(magnitude), kBigIntSummaryDigits);
+    const char* sign = header.negative && bits > 0 ? "-" : "";
+    stream.Printf("%s%s (", sign, decimal.c_str());
+    if (bits <= 128) stream.Printf("%s0x%s, ", sign, zdb::LimbsToHex(magnitude).c_str());
+    stream.Printf("%llu bits)", (unsigned long long)bits);
+    return true;
+}
+
+static bool ZigCStringSummary(SBValue value, SBTypeSummaryOptions options, SBStream &stream) {
+    uint64_t ptr_val = value.GetValueAsUnsigned(0);
+    if (ptr_val == 0) {
+        stream.Printf("null");
+        return true;
+    }
+    SBProcess process = value.GetProcess();
+    if (process.IsValid()) {
+        char buffer[256];
+        SBError error;
+        size_t bytes_read = process.ReadCStringFromMemory(ptr_val, buffer, sizeof(buffer), error);
+        if (bytes_read > 0 && error.Success()) {
+            stream.Printf("\"%s\"", buffer);
+            return true;
+        }
+    }
+    stream.Printf("0x%llx", (unsigned long long)ptr_val);
+    return true;
+}
+
+static bool ZigArraySummary(SBValue value, SBTypeSummaryOptions options, SBStream &stream) {
+    uint32_t num = value.GetNumChildren();
+    stream.Printf("[%u]...", num);
+    return true;
+}
+
+static bool ZigPointerSummary(SBValue value, SBTypeSummaryOptions options, SBStream &stream) {
+    uint64_t ptr_val = value.GetValueAsUnsigned(0);
+    if (ptr_val == 0) {
+        stream.Printf("null");
+        return true;
+    }
+    // Function pointers: the code they point to, from the symbol index
+    if (value.GetType().GetCanonicalType().GetPointeeType().IsFunctionType()) {
+        std::string symbol = SymbolTextAt(value.GetTarget(), ptr_val);
+        stream.Printf(symbol.empty() ? "0x%llx" : "0x%llx %s", (unsigned long long)ptr_val, symbol.c_str());
+        return true;
+    }
+    SBValue deref = value.Dereference();
+    if (deref.IsValid()) {
+        const char* summary = deref.GetSummary();
+        if (summary && summary[0]) {
+            stream.Printf("-> %s", summary);
+            return true;
+        }
+        const char* val = deref.GetValue();
+        if (val && val[0]) {
+            stream.Printf("-> %s", val);
+            return true;
+        }
+    }
+    stream.Printf("0x%llx", (unsigned long long)ptr_val);
+    return true;
+}
+
+static bool ZigStructSummary(SBValue value, SBTypeSummaryOptions options, SBStream &stream) {
+    // Packed structs: every field from one read of the backing integer
+    SBTarget target = value.GetTarget();
+    const PackedStructLayout& packed =
+        g_packed_struct_layouts.Get(TargetType{target, value.GetType()}, ClassifyPackedStruct);
+    if (packed.valid) {
+        std::vector<uint8_t> bytes(value.GetByteSize());
+        if (!bytes.empty() && ReadValueBytes(value, 0, bytes.data(), bytes.size())) {
+            PrintPackedFields(target, bytes.data(), bytes.size(), 0, packed, stream);
+            return true;
+        }
+    }
+
+    uint32_t num_children = value.GetNumChildren();
+
+    // Enum: no children, has a value
+    if (num_children == 0) {
+        const char* val = value.GetValue();
+        if (val && val[0]) {
+            stream.Printf(".%s", val);
+            return true;
+        }
+        stream.Printf("{}");
+        return true;
+    }
+
+    // Small structs: show inline
+    if (num_children <= 3) {
+        stream.Printf("{ ");
+        for (uint32_t i = 0; i < num_children; i++) {
+            if (i > 0) stream.Printf(", ");
+            SBValue child = value.GetChildAtIndex(i);
+            if (child.IsValid()) {
+                const char* name = child.GetName();
+                const char* summary = child.GetSummary();
+                if (summary && summary[0]) {
+                    stream.Printf(".%s=%s", name ? name : "?", summary);
+                } else {
+                    const char* val = child.GetValue();
+                    if (val && val[0]) {
+                        stream.Printf(".%s=%s", name ? name : "?", val);
+                    }
+                }
+            }
+        }
+        stream.Printf(" }");
+        return true;
+    }
+
+    stream.Printf("{ %u fields }", num_children);
+    return true;
+}
+
+// shared_ptr layout: { T* ptr, control_block* ctrl }
+struct SharedPtrLayout {
+    void* ptr;
+    void* ctrl;
+};
+
+//===----------------------------------------------------------------------===//
+// ABI-Compatible Types for Internal API
+//===----------------------------------------------------------------------===//
+
+// llvm::StringRef: passed as { const char*, size_t } on ARM64
+// On Apple ARM64, small structs (<=16 bytes) passed in registers
+
+// Note: SharedPtrLayout defined earlier in synthetic section
+
+// ConstString is just a const char* wrapper
+struct ConstString {
+    const char* m_string;
+    ConstString(const char* s) : m_string(s) {}
+};
+
+//===----------------------------------------------------------------------===//
+// Internal API Registration
+//===----------------------------------------------------------------------===//
+
+// Function pointer types matching LLDB internal ABI
+// GetCategory: void(ConstString, shared_ptr<TypeCategoryImpl>&, bool)
+// On ARM64: x0=ConstString (8 bytes), x1=&out_sp, x2=bool
+using GetCategoryFn = void (*)(
+    const char* name,           // ConstString passed as raw pointer
+    SharedPtrLayout* out_sp,    // Output: shared_ptr<TypeCategoryImpl>
+    bool can_create
+);
+
+// Enable: void(const shared_ptr<TypeCategoryImpl>&, uint32_t)
+using EnableFn = void (*)(
+    const SharedPtrLayout* category_sp,
+    uint32_t position
+);
+
+// AddTypeSummary: member function
+// void TypeCategoryImpl::AddTypeSummary(StringRef, FormatterMatchType, shared_ptr<TypeSummaryImpl>)
+// On ARM64: non-trivial types passed indirectly (pointer to struct)
+using AddTypeSummaryFn = void (*)(
+    void* this_ptr,             // TypeCategoryImpl*
+    const char* name_ptr,       // StringRef.data
+    size_t name_len,            // StringRef.length
+    int match_type,             // FormatterMatchType enum
+    SharedPtrLayout* sp         // shared_ptr passed indirectly
+);
+
+static bool RegisterFormatter(
+    void* category_impl,
+    AddTypeSummaryFn add_fn,
+    const char* pattern,
+    bool (*callback)(SBValue, SBTypeSummaryOptions, SBStream&),
+    const char* description,
+    bool is_regex = true,
+    bool hide_children = false
+) {
+    uint32_t options = eTypeOptionCascade;
+    if (hide_children) {
+        options |= eTypeOptionHideChildren;
+    }
+    SBTypeSummary summary = SBTypeSummary::CreateWithCallback(
+        callback, options, description);
+
+    if (!summary.IsValid()) return false;
+
+    g_formatters.push_back(summary);
+
+    // Extract shared_ptr from SBTypeSummary (only contains m_opaque_sp)
+    SharedPtrLayout* sp = (SharedPtrLayout*)&summary;
+
+    // Call internal AddTypeSummary
+    // FormatterMatchType: 0=Exact, 1=Regex, 2=Callback
+    add_fn(
+        category_impl,
+        pattern, strlen(pattern),
+        is_regex ? 1 : 0,
+        sp  // ARM64: non-trivial types passed indirectly
+    );
+
+    return true;
+}
+
+// Resolve liblldb path from the running process using dladdr
+static std::string ResolveLibLLDBPath() {
+    // 1. Check environment variable
+    const char* env_path = getenv("ZDB_LIBLLDB_PATH");
+    if (env_path && env_path[0]) {
+        return env_path;
+    }
+
+    // 2. Use dladdr on SBDebugger::GetVersionString to find loaded liblldb
+    Dl_info info;
+    if (dladdr((void*)&SBDebugger::GetVersionString, &info) && info.dli_fname) {
+        return info.dli_fname;
+    }
+
+    // 3. Platform-specific fallbacks
+#if defined(__APPLE__)
+    // Try Homebrew ARM64 first, then x86_64
+    const char* fallbacks[] = {
+        "/opt/homebrew/opt/llvm/lib/liblldb.dylib",
+        "/usr/local/opt/llvm/lib/liblldb.dylib",
+        "/Library/Developer/CommandLineTools/usr/lib/liblldb.dylib",
+        nullptr
+    };
+#else
+    // Linux fallbacks
+    const char* fallbacks[] = {
+        "/usr/lib/llvm-18/lib/liblldb.so",
+        "/usr/lib/llvm-17/lib/liblldb.so",
+        "/usr/lib/liblldb.so",
+        nullptr
+    };
+#endif
+    for (const char** p = fallbacks; *p; ++p) {
+        if (access(*p, R_OK) == 0) {
+            return *p;
+        }
+    }
+
+    return "";
+}
+
+static bool RegisterWithInternalAPI(SBDebugger debugger) {
+    // Get LLDB version - handle multiple formats:
+    // - Homebrew/upstream: "lldb version 21.1.7 ..."
+    // - Apple Xcode: "lldb-1703.0.234.3\nApple Swift version 6.2.1 ..."
+    // Check lldb- prefix FIRST (Apple format) to avoid matching "Swift version"
+    const char* version_str = SBDebugger::GetVersionString();
+    const char* ver;
+    if (strncmp(version_str, "lldb-", 5) == 0) {
+        ver = version_str + 5;  // Skip "lldb-"
+    } else if ((ver = strstr(version_str, "lldb version ")) != nullptr) {
+        ver += 13;  // Skip "lldb version "
+    } else {
+        // Try to find any leading digits
+        ver = version_str;
+        while (*ver && !isdigit(*ver)) ver++;
+        if (!*ver) {
+            fprintf(stderr, "[zdb] Could not parse LLDB version from: %s\n", version_str);
+            return false;
+        }
+    }
+
+    char version[32];
+    int i = 0;
+    while (ver[i] && (isdigit(ver[i]) || ver[i] == '.') && i < 31) {
+        version[i] = ver[i];
+        i++;
+    }
+    version[i] = '\0';
+
+    // Resolve liblldb path dynamically
+    std::string liblldb_path = ResolveLibLLDBPath();
+    if (liblldb_path.empty()) {
+        fprintf(stderr, "[zdb] Could not find liblldb. Set ZDB_LIBLLDB_PATH env var.\n");
+        return false;
+    }
+
+    // Load offsets
+    if (!zdb::g_symbols.load(liblldb_path.c_str(), version)) {
+        fprintf(stderr, "[zdb] No offsets for LLDB %s\n", version);
+        return false;
+    }
+
+    // Get function pointers
+    auto GetCategory = (GetCategoryFn)(zdb::g_symbols.base + zdb::g_symbols.table.GetCategory);
+    auto Enable = (EnableFn)(zdb::g_symbols.base + zdb::g_symbols.table.Enable);
+    auto AddTypeSummary = (AddTypeSummaryFn)(zdb::g_symbols.base + zdb::g_symbols.table.AddTypeSummary);
+
+    if (!zdb::g_symbols.table.GetCategory || !zdb::g_symbols.table.AddTypeSummary) {
+        fprintf(stderr, "[zdb] Missing required offsets\n");
+        return false;
+    }
+
+    // Get/create "zig" category
+    SharedPtrLayout category_sp = {nullptr, nullptr};
+    GetCategory("zig", &category_sp, true);
+
+    if (!category_sp.ptr) {
+        fprintf(stderr, "[zdb] Failed to create 'zig' category\n");
+        return false;
+    }
+
+    // Register formatters - LLDB uses LAST-MATCH, so register generic first, specific last
+
+    // 1. Catch-all for structs/enums (lowest priority)
+    // Matches: module.TypeName (e.g., test_types.Color, test_types.MyStruct)
+    RegisterFormatter(category_sp.ptr, AddTypeSummary, "^[a-z_][a-z0-9_]*\\.[A-Z][A-Za-z0-9_]*$", ZigStructSummary, "Zig struct/enum", true);
+    // Matches: standalone PascalCase types (e.g., Color, MyStruct)
+    RegisterFormatter(category_sp.ptr, AddTypeSummary, "^[A-Z][A-Za-z0-9_]*$", ZigStructSummary, "Zig type", true);
+
+    // 2. Generic Zig types
+    RegisterFormatter(category_sp.ptr, AddTypeSummary, "^\\[.*\\].*$", ZigArraySummary, "Zig array", true);
+    RegisterFormatter(category_sp.ptr, AddTypeSummary, "^\\[\\].*$", ZigSliceSummary, "Zig slice", true);
+    RegisterFormatter(category_sp.ptr, AddTypeSummary, "^\\?.*$", ZigOptionalSummary, "Zig optional", true);
+    RegisterFormatter(category_sp.ptr, AddTypeSummary, "^.*!.*$", ZigErrorUnionSummary, "Zig error union", true);
+    RegisterFormatter(category_sp.ptr, AddTypeSummary, "^union\\(.*\\)$", ZigTaggedUnionSummary, "Zig tagged union", true);
+    RegisterFormatter(category_sp.ptr, AddTypeSummary, "^\\*.*$", ZigPointerSummary, "Zig pointer", true);
+    RegisterFormatter(category_sp.ptr, AddTypeSummary, "^\\[\\*\\].*$", ZigPointerSummary, "Zig many pointer", true);
+    RegisterFormatter(category_sp.ptr, AddTypeSummary, "^\\[\\*:.*\\].*$", ZigPointerSummary, "Zig sentinel pointer", true);
+
+    // 3. std library types (hide children - internal structure not useful)
+    RegisterFormatter(category_sp.ptr, AddTypeSummary, "^array_list\\..*$", ZigArrayListSummary, "Zig ArrayList", true, true);
+    RegisterFormatter(category_sp.ptr, AddTypeSummary, "^hash_map\\..*$", ZigHashMapSummary, "Zig HashMap", true, true);
+    RegisterFormatter(category_sp.ptr, AddTypeSummary, "^array_hash_map\\.ArrayHashMap[A-Za-z]*\\(.*\\)$", ZigArrayHashMapSummary, "Zig ArrayHashMap", true, true);
+    RegisterFormatter(category_sp.ptr, AddTypeSummary, "^bounded_array\\..*$", ZigBoundedArraySummary, "Zig BoundedArray", true, true);
+    RegisterFormatter(category_sp.ptr, AddTypeSummary, "^multi_array_list\\..*$", ZigMultiArrayListSummary, "Zig MultiArrayList", true, true);
+    RegisterFormatter(category_sp.ptr, AddTypeSummary, "^segmented_list\\..*$", ZigSegmentedListSummary, "Zig SegmentedList", true, true);
+    RegisterFormatter(category_sp.ptr, AddTypeSummary, "^(linked_list\\.)?(Singly|Doubly)LinkedList(\\(.*\\))?$", ZigLinkedListSummary, "Zig linked list", true, true);
+    RegisterFormatter(category_sp.ptr, AddTypeSummary, "^(fifo\\.LinearFifo|deque\\.Deque)\\(.*\\)$", ZigRingBufferSummary, "Zig LinearFifo/Deque", true, true);
+    RegisterFormatter(category_sp.ptr, AddTypeSummary, "^(priority_queue\\.PriorityQueue|priority_dequeue\\.PriorityDequeue)\\(.*\\)$", ZigPriorityQueueSummary, "Zig PriorityQueue/PriorityDequeue", true, true);
+    RegisterFormatter(category_sp.ptr, AddTypeSummary, "^treap\\.Treap\\(.*\\)$", ZigTreapSummary, "Zig Treap", true, true);
+    RegisterFormatter(category_sp.ptr, AddTypeSummary, "^enums\\.(EnumArray|EnumMap|EnumSet)\\(.*\\)$", ZigEnumContainerSummary, "Zig EnumArray/EnumMap/EnumSet", true, true);
+    RegisterFormatter(category_sp.ptr, AddTypeSummary, "^json\\.dynamic\\.Value$", ZigJsonValueSummary, "Zig std.json.Value", true, true);
+    RegisterFormatter(category_sp.ptr, AddTypeSummary, "^math\\.big\\.int\\.(Managed|Mutable|Const)$", ZigBigIntSummary, "Zig std.math.big.int", true, true);
+    RegisterFormatter(category_sp.ptr, AddTypeSummary, "^heap\\.arena_allocator\\.ArenaAllocator$", ZigArenaAllocatorSummary, "Zig ArenaAllocator", true, true);
+    RegisterFormatter(category_sp.ptr, AddTypeSummary, "^heap\\.FixedBufferAllocator$", ZigFixedBufferAllocatorSummary, "Zig FixedBufferAllocator", true, true);
+    RegisterFormatter(category_sp.ptr, AddTypeSummary, "^heap\\.memory_pool\\.MemoryPool[A-Za-z]*\\(.*\\)$", ZigMemoryPoolSummary, "Zig MemoryPool", true, true);
+    RegisterFormatter(category_sp.ptr, AddTypeSummary, "^Thread\\.Pool$", ZigThreadPoolSummary, "Zig Thread.Pool", true, true);
+    RegisterFormatter(category_sp.ptr, AddTypeSummary, "^Thread\\.WaitGroup$", ZigWaitGroupSummary, "Zig Thread.WaitGroup", true, true);
+    RegisterFormatter(category_sp.ptr, AddTypeSummary, "^os\\.linux\\.IoUring$", ZigIoUringSummary, "Zig os.linux.IoUring", true, true);
+    RegisterFormatter(category_sp.ptr, AddTypeSummary, "^mem\\.Allocator$", ZigInterfaceSummary, "Zig ptr + vtable interface", true, true);
+    RegisterFormatter(category_sp.ptr, AddTypeSummary, "^Io\\.(Reader|Writer)$", ZigIoBufferSummary, "Zig Io.Reader/Io.Writer", true, true);
+    RegisterFormatter(category_sp.ptr, AddTypeSummary, "^io\\.buffered_(reader|writer)\\.Buffered(Reader|Writer)\\(.*\\)$", ZigIoBufferSummary, "Zig BufferedReader/BufferedWriter", true, true);
+    RegisterFormatter(category_sp.ptr, AddTypeSummary, "^@Vector\\(.*\\)$", ZigVectorSummary, "Zig @Vector", true, true);
+    RegisterFormatter(category_sp.ptr, AddTypeSummary, "^bit_set\\.(IntegerBitSet|ArrayBitSet|DynamicBitSet|DynamicBitSetUnmanaged)(\\(.*\\))?$", ZigBitSetSummary, "Zig bit set", true, true);
+
+    // 4. C strings (hide children - just show the string)
+    RegisterFormatter(category_sp.ptr, AddTypeSummary, "^\\[\\*:0\\]u8$", ZigCStringSummary, "Zig C string", true, true);
+    RegisterFormatter(category_sp.ptr, AddTypeSummary, "^\\[\\*:0\\]const u8$", ZigCStringSummary, "Zig const C string", true, true);
+
+    // 5. Specific string types (hide children - just show the string)
+    RegisterFormatter(category_sp.ptr, AddTypeSummary, "^\\[\\]const u8$", ZigStringSummary, "Zig const string", true, true);
+    RegisterFormatter(category_sp.ptr, AddTypeSummary, "^\\[\\]u8$", ZigStringSummary, "Zig string", true, true);
+
+    // 6. Synthetic children providers
+    // NOT SUPPORTED - LLDB's SBTypeSynthetic only has Python callbacks, no C callback API.
+    // The internal AddTypeSynthetic registers but lookup fails (unknown reason).
+    // Workaround: Use `p slice[n]` expression syntax (implemented in ZigExpressionCommand)
+
+    // Enable category
+    if (zdb::g_symbols.table.Enable) {
+        Enable(&category_sp, 0);
+    }
+
+    return true;
+}
+
+//===----------------------------------------------------------------------===//
+// Zig Expression Transformer
+//===----------------------------------------------------------------------===//
+
+// Transform Zig expressions to C equivalents:
+//   slice[n]       -> slice.ptr[n]
+//   arraylist[n]   -> arraylist.items.ptr[n]
+//   optional.?     -> optional.data
+//   err catch val  -> (err.tag == 0 ? err.value : val)
+//   map.get(key)   -> (*(V*)0xADDR), located natively (scalar V only)
+
+namespace {
+
+// Navigate a dot-separated path from a frame to get the SBValue
+SBValue GetValueAtPath(SBFrame frame, const std::string& path) {
+    if (path.empty()) return SBValue();
+
+    size_t dot = path.find('.');
+    std::string root = (dot == std::string::npos) ? path : path.substr(0, dot);
+    SBValue val = frame.FindVariable(root.c_str());
+
+    if (!val.IsValid()) return SBValue();
+    if (dot == std::string::npos) return val;
+
+    // Navigate remaining path segments
+    size_t pos = dot + 1;
+    while (pos < path.length()) {
+        size_t next = path.find('.', pos);
+        std::string member = (next == std::string::npos)
+            ? path.substr(pos)
+            : path.substr(pos, next - pos);
+        val = val.GetChildMemberWithName(member.c_str());
+        if (!val.IsValid()) return SBValue();
+        pos = (next == std::string::npos) ? path.length() : next + 1;
+    }
+    return val;
+}
+
+// Type detection helpers
+bool IsZigSlice(SBValue val) {
+    if (!val.IsValid()) return false;
+    return val.GetChildMemberWithName("ptr").IsValid()
+        && val.GetChildMemberWithName("len").IsValid();
+}
+
+bool IsZigArrayList(SBValue val) {
+    if (!val.IsValid()) return false;
+    SBValue items = val.GetChildMemberWithName("items");
+    return items.IsValid() && IsZigSlice(items)
+        && val.GetChildMemberWithName("capacity").IsValid();
+}
+
+bool IsZigErrorUnion(SBValue val) {
+    if (!val.IsValid()) return false;
+    // Zig error unions have 'tag' (error code) and 'value' (payload) fields
+    return val.GetChildMemberWithName("tag").IsValid()
+        && val.GetChildMemberWithName("value").IsValid();
+}
+
+// Generic regex-based transformer
+using TransformFn = std::function<std::string(const std::smatch&, SBFrame)>;
+
+std::string ApplyRegexTransform(
+    const std::string& input,
+    const std::regex& pattern,
+    SBFrame frame,
+    TransformFn transform
+) {
+    std::string result;
+    std::string::const_iterator search_start = input.cbegin();
+    size_t last_end = 0;
+
+    std::smatch match;
+    while (std::regex_search(search_start, input.cend(), match, pattern)) {
+        size_t match_start = (search_start - input.cbegin()) + match.position();
+
+        // Try transformation
+        std::string replacement = transform(match, frame);
+        if (!replacement.empty()) {
+            result += input.substr(last_end, match_start - last_end);
+            result += replacement;
+            last_end = match_start + match.length();
+        }
+        search_start = match.suffix().first;
+    }
+
+    if (last_end == 0) return input;  // No transformations
+    result += input.substr(last_end);
+    return result;
+}
+
+} // anonymous namespace
+
+// C spelling of a value at a known address; only builtin types have one
+// that LLDB's expression parser accepts
+static std::string TypedAddressExpression(SBType type, uint64_t addr) {
+    SBType canonical = type.GetCanonicalType();
+    if (canonical.GetTypeClass() != eTypeClassBuiltin || !canonical.GetName()) return "";
+    char buf[32];
+    snprintf(buf, sizeof(buf), "0x%llx", (unsigned long long)addr);
+    return std::string("(*(") + canonical.GetName() + "*)" + buf + ")";
+}
+
+// path[index]
+static const std::regex& SubscriptPattern() {
+    static const std::regex pattern(R"(([\w.]+)\s*\[([^\]]+)\])");
+    return pattern;
+}
+
+// A literal element index (decimal or 0x hex)
+static bool ParseIndex(const std::string& text, uint64_t& index) {
+    if (text.empty()) return false;
+    char* end = nullptr;
+    index = strtoull(text.c_str(), &end, 0);
+    return end && *end == '\0';
+}
+
+// list.items(.field)[i]
+static const std::regex& MultiArrayListItemPattern() {
+    static const std::regex pattern(R"(([\w.]+)\s*\.\s*items\s*\(\s*\.(\w+)\s*\)\s*\[\s*(\w+)\s*\])");
+    return pattern;
+}
+
+// map.get(key), optionally followed by .?
+static const std::regex& HashMapGetPattern() {
+    static const std::regex pattern(
+        R"rx(([\w.]+)\s*\.\s*get\s*\(\s*("(?:[^"\\]|\\.)*"|[^()"]*?)\s*\)(\s*\.\s*\?)?)rx");
+    return pattern;
+}
+
+static std::string TransformZigExpression(const std::string& expr, SBFrame frame) {
+    std::string result = expr;
+
+    // 0. Transform map lookup: map.get(key) -> (*(V*)addr). The slot is found
+    // natively; only builtin V types have a C spelling LLDB can parse.
+    result = ApplyRegexTransform(result, HashMapGetPattern(), frame,
+        [](const std::smatch& m, SBFrame f) -> std::string {
+            SBValue val = GetValueAtPath(f, m[1].str());
+            if (!IsZigHashMap(val)) return "";
+
+            HashMapLookup lookup;
+            SBType value_type;
+            std::string error;
+            if (!ZigHashMapGet(val, m[2].str(), lookup, value_type, error) || !lookup.found) return "";
+            return TypedAddressExpression(value_type, lookup.value_addr);
+        });
+
+    // 0b. Transform column access: list.items(.field)[i] -> (*(T*)addr), the
+    // column offset coming from the cached MultiArrayList layout
+    result = ApplyRegexTransform(result, MultiArrayListItemPattern(), frame,
+        [](const std::smatch& m, SBFrame f) -> std::string {
+            SBValue list = GetValueAtPath(f, m[1].str());
+            uint64_t addr = 0;
+            SBType type;
+            std::string error;
+            uint64_t index = strtoull(m[3].str().c_str(), nullptr, 0);
+            if (!list.IsValid() || !ZigMultiArrayListElement(list, m[2].str(), index, addr, type, error)) {
+                return "";
+            }
+            return TypedAddressExpression(type, addr);
+        });
+
+    // 1. Transform subscript: slice[n] -> slice.ptr[n], arraylist[n] -> arraylist.items.ptr[n],
+    // seglist[n] -> (*(T*)addr) via the shelf/box index math
+    result = ApplyRegexTransform(result, SubscriptPattern(), frame,
+        [](const std::smatch& m, SBFrame f) -> std::string {
+            std::string path = m[1].str();
+            std::string index = m[2].str();
+            SBValue val = GetValueAtPath(f, path);
+
+            if (IsZigSegmentedList(val)) {
+                uint64_t n = 0, addr = 0;
+                SBType type;
+                std::string error;
+                if (!ParseIndex(index, n) || !ZigSegmentedListElement(val, n, addr, type, error)) return "";
+                return TypedAddressExpression(type, addr);
+            }
+            if (IsZigSlice(val)) {
+                return path + ".ptr[" + index + "]";
+            }
+            if (IsZigArrayList(val)) {
+                return path + ".items.ptr[" + index + "]";
+            }
+            return "";  // No transformation
+        });
+
+    // 2. Transform optional unwrap: optional.? -> ternary for safe null handling
+    // The rewrite depends on how the optional type encodes null
+    static const std::regex optional_pattern(R"(([\w.]+)\s*\.\s*\?)");
+    result = ApplyRegexTransform(result, optional_pattern, frame,
+        [](const std::smatch& m, SBFrame f) -> std::string {
+            std::string path = m[1].str();
+            SBValue val = GetValueAtPath(f, path);
+            if (!val.IsValid()) return "";
+
+            switch (GetOptionalLayout(val).encoding) {
+            case OptionalEncoding::Flag:
+                // Use ternary for runtime null check - shows data or 0 for null
+                return "(" + path + ".some ? " + path + ".data : 0)";
+            case OptionalEncoding::NullPointer:
+                // Non-null dereferences, null returns 0
+                return "(" + path + " ? *" + path + " : 0)";
+            case OptionalEncoding::NullSlicePtr:
+            case OptionalEncoding::ErrorSetZero:
+                // Payload shares the optional's storage
+                return path;
+            case OptionalEncoding::Unknown:
+                break;
+            }
+            return "";
+        });
+
+    // 3. Transform error catch: err catch default -> (err.tag == 0 ? err.value : default)
+    static const std::regex catch_pattern(R"(([\w.]+)\s+catch\s+([\w.]+))");
+    result = ApplyRegexTransform(result, catch_pattern, frame,
+        [](const std::smatch& m, SBFrame f) -> std::string {
+            std::string path = m[1].str();
+            std::string dflt = m[2].str();
+            SBValue val = GetValueAtPath(f, path);
+
+            if (IsZigErrorUnion(val)) {
+                return "(" + path + ".tag == 0 ? " + path + ".value : " + dflt + ")";
+            }
+            return "";
+        });
+
+    return result;
+}
+
+// Print a natively located value the way 'p' would
+static void AppendValueAtAddress(SBFrame frame, const std::string& name, uint64_t addr,
+                                 SBType type, SBCommandReturnObject& result) {
+    SBTarget target = frame.GetThread().GetProcess().GetTarget();
+    SBValue value = target.CreateValueFromAddress(name.c_str(), SBAddress(addr, target), type);
+    SBStream stream;
+    value.GetDescription(stream);
+    result.AppendMessage(stream.GetData());
+}
+
+// Whole-expression forms zdb answers itself from target memory, for any
+// result type. Returns false when `expr` is not one of them.
+static bool EvaluateNativeZigExpression(const std::string& expr, SBFrame frame,
+                                        SBCommandReturnObject& result) {
+    std::smatch m;
+    if (std::regex_match(expr, m, SubscriptPattern())) {
+        SBValue list = GetValueAtPath(frame, m[1].str());
+        uint64_t index = 0;
+        if (!IsZigSegmentedList(list) || !ParseIndex(m[2].str(), index)) return false;
+        uint64_t addr = 0;
+        SBType type;
+        std::string error;
+        if (!ZigSegmentedListElement(list, index, addr, type, error)) {
+            result.SetError(error.c_str());
+            return true;
+        }
+        AppendValueAtAddress(frame, expr, addr, type, result);
+        result.SetStatus(eReturnStatusSuccessFinishResult);
+        return true;
+    }
+    if (std::regex_match(expr, m, MultiArrayListItemPattern())) {
+        SBValue list = GetValueAtPath(frame, m[1].str());
+        if (!list.IsValid()) return false;
+        uint64_t addr = 0;
+        SBType type;
+        std::string error;
+        uint64_t index = strtoull(m[3].str().c_str(), nullptr, 0);
+        if (!ZigMultiArrayListElement(list, m[2].str(), index, addr, type, error)) {
+            if (!IsZigMultiArrayList(list)) return false;
+            result.SetError(error.c_str());
+            return true;
+        }
+        AppendValueAtAddress(frame, expr, addr, type, result);
+        result.SetStatus(eReturnStatusSuccessFinishResult);
+        return true;
+    }
+
+    if (std::regex_match(expr, m, HashMapGetPattern())) {
+        SBValue map = GetValueAtPath(frame, m[1].str());
+        if (!IsZigHashMap(map)) return false;
+
+        HashMapLookup lookup;
+        SBType value_type;
+        std::string error;
+        if (!ZigHashMapGet(map, m[2].str(), lookup, value_type, error)) {
+            result.SetError(error.c_str());
+            return true;
+        }
+        if (!lookup.found) {
+            result.AppendMessage("null");
+        } else if (!value_type.IsValid() || value_type.GetByteSize() == 0) {
+            result.AppendMessage("(void) found");
+        } else {
+            AppendValueAtAddress(frame, expr, lookup.value_addr, value_type, result);
+        }
+        result.SetStatus(eReturnStatusSuccessFinishResult);
+        return true;
+    }
+    return false;
+}
+
+//===----------------------------------------------------------------------===//
+// Custom Expression Command (overrides 'p')
+//===----------------------------------------------------------------------===//
+
+// Resolve the selected frame for a command, reporting why it is unavailable
+static bool GetCommandFrame(SBDebugger debugger, SBCommandReturnObject& result, SBFrame& frame) {
+    SBTarget target = debugger.GetSelectedTarget();
+    if (!target.IsValid()) {
+        result.SetError("error: no target");
+        return false;
+    }
+
+    SBProcess process = target.GetProcess();
+    if (!process.IsValid()) {
+        result.SetError("error: no process");
+        return false;
+    }
+
+    SBThread thread = process.GetSelectedThread();
+    if (!thread.IsValid()) {
+        result.SetError("error: no thread");
+        return false;
+    }
+
+    frame = thread.GetSelectedFrame();
+    if (!frame.IsValid()) {
+        result.SetError("error: no frame");
+        return false;
+    }
+    return true;
+}
+
+// Positional arguments plus --name value options. Names listed in `flags`
+// take no value.
+struct CommandArgs {
+    std::vector<std::string> positional;
+    std::unordered_map<std::string, std::string> options;
+
+    bool Has(const char* name) const { return options.count(name) != 0; }
+
+    uint64_t GetUnsigned(const char* name, uint64_t fallback) const {
+        auto it = options.find(name);
+        if (it == options.end()) return fallback;
+        return strtoull(it->second.c_str(), nullptr, 0);
+    }
+
+    std::string GetString(const char* name, const std::string& fallback = "") const {
+        auto it = options.find(name);
+        return it == options.end() ? fallback : it->second;
+    }
+};
+
+static CommandArgs ParseCommandArgs(char** command, std::initializer_list<const char*> flags = {}) {
+    CommandArgs args;
+    for (int i = 0; command && command[i]; i++) {
+        const char* arg = command[i];
+        if (strncmp(arg, "--", 2) != 0) {
+            args.positional.push_back(arg);
+            continue;
+        }
+        std::string name = arg + 2;
+        bool is_flag = std::any_of(flags.begin(), flags.end(),
+            [&](const char* f) { return name == f; });
+        if (!is_flag && command[i + 1]) {
+            args.options[name] = command[++i];
+        } else {
+            args.options[name] = "1";
+        }
+    }
+    return args;
+}
+
+// Look up a command argument as a variable path, then as an expression
+static SBValue ResolveCommandValue(SBFrame frame, const std::string& expr) {
+    SBValue value = GetValueAtPath(frame, expr);
+    if (value.IsValid()) return value;
+    value = frame.GetValueForVariablePath(expr.c_str());
+    if (value.IsValid() && value.GetError().Success()) return value;
+    SBExpressionOptions options;
+    options.SetTimeoutInMicroSeconds(5000000);  // 5 seconds
+    return frame.EvaluateExpression(expr.c_str(), options);
+}
+
+class ZigExpressionCommand : public SBCommandPluginInterface {
+public:
+    bool DoExecute(SBDebugger debugger, char** command, SBCommandReturnObject& result) override {
+        // Reconstruct the expression from command arguments
+        std::string expr;
+        if (command) {
+            for (int i = 0; command[i] != nullptr; ++i) {
+                if (i > 0) expr += " ";
+                expr += command[i];
+            }
+        }
+
+        if (expr.empty()) {
+            result.SetError("error: no expression provided");
+            return false;
+        }
+
+        // Get current frame
+        SBFrame frame;
+        if (!GetCommandFrame(debugger, result, frame)) return false;
+
+        // Forms evaluated natively, without the expression parser
+        if (EvaluateNativeZigExpression(expr, frame, result)) {
+            return result.Succeeded();
+        }
+
+        // Transform Zig expressions to C
+        std::string transformed = TransformZigExpression(expr, frame);
+
+        // Evaluate the transformed expression
+        SBExpressionOptions options;
+        options.SetTimeoutInMicroSeconds(5000000);  // 5 seconds
+
+        SBValue value = frame.EvaluateExpression(transformed.c_str(), options);
+
+        if (value.GetError().Fail()) {
+            // If transformation didn't help, try original expression
+            if (transformed != expr) {
+                value = frame.EvaluateExpression(expr.c_str(), options);
+            }
+            if (value.GetError().Fail()) {
+                result.SetError(value.GetError().GetCString());
+                return false;
+            }
+        }
+
+        // Format output like standard 'p' command
+        SBStream stream;
+        value.GetDescription(stream);
+        result.AppendMessage(stream.GetData());
+        result.SetStatus(eReturnStatusSuccessFinishResult);
+
+        return true;
+    }
+};
+
+// Global instance to prevent destruction
+static ZigExpressionCommand* g_zig_expr_cmd = nullptr;
+
+//===----------------------------------------------------------------------===//
+// Zig Inspection Commands
+//===----------------------------------------------------------------------===//
+
+// zig map <map> [--from cursor] [--count N]: page through occupied slots.
+// Metadata is scanned in windows; keys and values of a window's occupied
+// slots are fetched with one read each and rendered by the registered
+// summaries. The printed cursor resumes the walk.
+class ZigMapCommand : public SBCommandPluginInterface {
+public:
+    static constexpr uint64_t kWindowSlots = 64 * 1024;
+
+    bool DoExecute(SBDebugger debugger, char** command, SBCommandReturnObject& result) override {
+        CommandArgs args = ParseCommandArgs(command);
+        if (args.positional.empty()) {
+            result.SetError("usage: zig map <map> [--from cursor] [--count N]");
+            return false;
+        }
+        SBFrame frame;
+        if (!GetCommandFrame(debugger, result, frame)) return false;
+
+        SBValue value = ResolveCommandValue(frame, args.positional[0]);
+        if (!value.IsValid()) {
+            result.SetError("error: no such variable");
+            return false;
+        }
+        SBValue map = ResolveHashMapUnmanaged(value);
+        const HashMapLayout& layout = g_hash_map_layouts.Get(map, ClassifyHashMap);
+        HashMapState state;
+        if (!ReadHashMapState(map, layout, state)) {
+            result.SetError("error: not a std.HashMap (or its header is unreadable)");
+            return false;
+        }
+        if (layout.key_size == 0) {
+            result.SetError("error: key/value types not found in debug info");
+            return false;
+        }
+
+        SBTarget target = frame.GetThread().GetProcess().GetTarget();
+        SBProcess process = target.GetProcess();
+        uint64_t key_size = layout.key_size;
+        uint64_t value_size = layout.value_size;
+        uint64_t slot = args.GetUnsigned("from", 0);
+        uint64_t remaining = args.GetUnsigned("count", 32);
+
+        std::vector<uint8_t> metadata, keys, values;
+        std::vector<uint64_t> used;
+        while (remaining > 0 && slot < state.capacity) {
+            uint64_t window = std::min(kWindowSlots, state.capacity - slot);
+            if (!ReadTargetMemory(process, state.metadata + slot, window, metadata)) {
+                result.SetError("error: failed to read metadata");
+                return false;
+            }
+            used.clear();
+            zdb::CollectUsedSlots(metadata.data(), window, slot, remaining, used);
+            if (used.empty()) {
+                slot += window;
+                continue;
+            }
+
+            // Keys and values of this window's hits, one read each
+            uint64_t first = used.front(), span = used.back() - first + 1;
+            bool ok = ReadTargetMemory(process, state.keys + first * key_size, span * key_size, keys);
+            if (ok && value_size > 0) {
+                ok = ReadTargetMemory(process, state.values + first * value_size, span * value_size, values);
+            }
+            if (!ok) {
+                result.SetError("error: failed to read keys/values");
+                return false;
+            }
+
+            for (uint64_t idx : used) {
+                uint64_t rel = idx - first;
+                std::string name = "[" + std::to_string(idx) + "]";
+                SBValue key = MakeValueFromBytes(target, name.c_str(),
+                    keys.data() + rel * key_size, key_size, layout.key_type);
+                if (value_size > 0) {
+                    SBValue val = MakeValueFromBytes(target, name.c_str(),
+                        values.data() + rel * value_size, value_size, layout.value_type);
+                    result.Printf("%s %s = %s\n", name.c_str(),
+                        ValueText(key).c_str(), ValueText(val).c_str());
+                } else {
+                    result.Printf("%s %s\n", name.c_str(), ValueText(key).c_str());
+                }
+            }
+            remaining -= used.size();
+            slot = used.back() + 1;
+        }
+
+        if (slot < state.capacity) {
+            result.Printf("next: --from %llu\n", (unsigned long long)slot);
+        } else {
+            result.Printf("end (size=%llu)\n", (unsigned long long)state.size);
+        }
+        result.SetStatus(eReturnStatusSuccessFinishResult);
+        return true;
+    }
+};
+
+// zig column <list> .field [start[..end]]: one column of a MultiArrayList,
+// fetched with a single read of just that column's rows
+class ZigColumnCommand : public SBCommandPluginInterface {
+public:
+    static constexpr uint64_t kDefaultRows = 32;
+
+    bool DoExecute(SBDebugger debugger, char** command, SBCommandReturnObject& result) override {
+        CommandArgs args = ParseCommandArgs(command);
+        if (args.positional.size() < 2) {
+            result.SetError("usage: zig column <list> .field [start[..end]]");
+            return false;
+        }
+        SBFrame frame;
+        if (!GetCommandFrame(debugger, result, frame)) return false;
+
+        SBValue list = ResolveCommandValue(frame, args.positional[0]);
+        if (list.GetType().IsPointerType()) list = list.Dereference();
+        MultiArrayListState state;
+        if (!IsZigMultiArrayList(list) || !ReadMultiArrayListState(list, state)) {
+            result.SetError("error: not a std.MultiArrayList");
+            return false;
+        }
+        std::string field = args.positional[1];
+        if (!field.empty() && field[0] == '.') field = field.substr(1);
+        const MultiArrayListLayout& layout = g_multi_array_list_layouts.Get(list, ClassifyMultiArrayList);
+        const MultiArrayListColumn* column = layout.Find(field.c_str());
+        if (!column) {
+            result.SetError(("error: no field '" + field + "' (or element type not in debug info)").c_str());
+            return false;
+        }
+
+        // Range: "n" is a single row, "a..b" is half-open
+        uint64_t start = 0, end = std::min(state.len, kDefaultRows);
+        if (args.positional.size() > 2) {
+            const std::string& range = args.positional[2];
+            size_t dots = range.find("..");
+            start = strtoull(range.c_str(), nullptr, 0);
+            if (dots == std::string::npos) {
+                end = start + 1;
+            } else {
+                end = dots + 2 < range.size() ? strtoull(range.c_str() + dots + 2, nullptr, 0) : state.len;
+            }
+        }
+        end = std::min(end, state.len);
+        if (start >= end) {
+            result.Printf("(empty range, len=%llu)\n", (unsigned long long)state.len);
+            result.SetStatus(eReturnStatusSuccessFinishResult);
+            return true;
+        }
+
+        SBTarget target = list.GetTarget();
+        std::vector<uint8_t> rows;
+        if (!ReadMultiArrayListColumn(list.GetProcess(), state, *column, start, end - start, rows)) {
+            result.SetError("error: failed to read column");
+            return false;
+        }
+        for (uint64_t i = start; i < end; i++) {
+            std::string name = "[" + std::to_string(i) + "]";
+            SBValue row = MakeValueFromBytes(target, name.c_str(),
+                rows.data() + (i - start) * column->size, column->size, column->type);
+            result.Printf("%s %s\n", name.c_str(), ValueText(row).c_str());
+        }
+        if (end < state.len) {
+            result.Printf("... (len=%llu)\n", (unsigned long long)state.len);
+        }
+        result.SetStatus(eReturnStatusSuccessFinishResult);
+        return true;
+    }
+};
+
+// zig walk <list|node> [--count N] [--budget N]: follow `next` pointers,
+// printing the first N nodes and counting the rest up to the budget
+class ZigWalkCommand : public SBCommandPluginInterface {
+public:
+    static constexpr uint64_t kDefaultCount = 32;
+    static constexpr uint64_t kDefaultBudget = 1000000;
+
+    bool DoExecute(SBDebugger debugger, char** command, SBCommandReturnObject& result) override {
+        CommandArgs args = ParseCommandArgs(command);
+        if (args.positional.empty()) {
+            result.SetError("usage: zig walk <list|node> [--count N] [--budget N]");
+            return false;
+        }
+        SBFrame frame;
+        if (!GetCommandFrame(debugger, result, frame)) return false;
+
+        SBValue value = ResolveCommandValue(frame, args.positional[0]);
+        const LinkedListLayout* layout = nullptr;
+        uint64_t first = 0;
+        if (!value.IsValid() || !LinkedListStart(value, layout, first)) {
+            result.SetError("error: not a linked list or list node");
+            return false;
+        }
+        uint64_t count = args.GetUnsigned("count", kDefaultCount);
+        uint64_t budget = args.GetUnsigned("budget", kDefaultBudget);
+
+        SBProcess process = value.GetProcess();
+        SBTarget target = value.GetTarget();
+        LinkedListWalk walk;
+        WalkLinkedList(process, *layout, first, budget, count, walk);
+        for (size_t i = 0; i < walk.nodes.size(); i++) {
+            if (layout->has_data) {
+                result.Printf("[%zu] 0x%llx %s\n", i, (unsigned long long)walk.nodes[i],
+                    LinkedListNodeText(process, target, *layout, walk.nodes[i]).c_str());
+            } else {
+                result.Printf("[%zu] 0x%llx\n", i, (unsigned long long)walk.nodes[i]);
+            }
+        }
+
+        switch (walk.outcome) {
+        case LinkedListWalk::Outcome::End:
+            result.Printf("end (len=%llu)\n", (unsigned long long)walk.count);
+            break;
+        case LinkedListWalk::Outcome::Cycle:
+            result.Printf("cycle: node [%llu] is revisited after %llu nodes (cycle length %llu)\n",
+                (unsigned long long)walk.cycle_start, (unsigned long long)walk.count,
+                (unsigned long long)walk.cycle_length);
+            break;
+        case LinkedListWalk::Outcome::Budget:
+            result.Printf("stopped after %llu nodes (raise --budget)\n", (unsigned long long)walk.count);
+            break;
+        case LinkedListWalk::Outcome::ReadError:
+            result.Printf("unreadable next pointer after %llu nodes\n", (unsigned long long)walk.count);
+            break;
+        }
+        result.SetStatus(eReturnStatusSuccessFinishResult);
+        return true;
+    }
+};
+
+// zig bits <set> [--ranges] [--count N]: occupancy of a bit set, then its
+// first N set indices or, with --ranges, its first N runs of set bits
+class ZigBitsCommand : public SBCommandPluginInterface {
+public:
+    static constexpr uint64_t kDefaultCount = 64;
+
+    bool DoExecute(SBDebugger debugger, char** command, SBCommandReturnObject& result) override {
+        CommandArgs args = ParseCommandArgs(command, {"ranges"});
+        if (args.positional.empty()) {
+            result.SetError("usage: zig bits <set> [--ranges] [--count N]");
+            return false;
+        }
+        SBFrame frame;
+        if (!GetCommandFrame(debugger, result, frame)) return false;
+
+        SBValue value = ResolveCommandValue(frame, args.positional[0]);
+        uint64_t nbits = 0;
+        std::vector<uint8_t> bytes;
+        std::string error;
+        if (!value.IsValid() || !IsZigBitSet(value)) {
+            result.SetError("error: not a std bit set");
+            return false;
+        }
+        if (!ReadBitSet(value, UINT64_MAX, nbits, bytes, error)) {
+            result.SetError(error.c_str());
+            return false;
+        }
+        uint64_t count = args.GetUnsigned("count", kDefaultCount);
+
+        uint64_t set = zdb::PopCountBits(bytes.data(), nbits);
+        result.Printf("bits=%llu set=%llu (%.1f%%) clear=%llu\n", (unsigned long long)nbits,
+            (unsigned long long)set, nbits ? 100.0 * set / nbits : 0.0, (unsigned long long)(nbits - set));
+
+        std::string line;
+        bool complete = true;
+        if (args.Has("ranges")) {
+            std::vector<zdb::BitRange> ranges;
+            complete = zdb::CollectSetRanges(bytes.data(), nbits, count, ranges);
+            for (const zdb::BitRange& range : ranges) {
+                if (!line.empty()) line += ", ";
+                line += std::to_string(range.start);
+                if (range.end - range.start > 1) line += "-" + std::to_string(range.end - 1);
+            }
+            result.Printf("ranges: %s%s\n", line.empty() ? "(none)" : line.c_str(), complete ? "" : ", ...");
+        } else {
+            std::vector<uint64_t> indices;
+            zdb::FindSetBits(bytes.data(), nbits, 0, count, indices);
+            for (uint64_t index : indices) {
+                if (!line.empty()) line += ", ";
+                line += std::to_string(index);
+            }
+            complete = indices.size() == set;
+            result.Printf("set: %s%s\n", line.empty() ? "(none)" : line.c_str(), complete ? "" : ", ...");
+        }
+        result.SetStatus(eReturnStatusSuccessFinishResult);
+        return true;
+    }
+};
+
+// zig heap-top <queue> [K] [--field name]: the K highest-priority entries
+// of a PriorityQueue/PriorityDequeue, from one read of the backing array
+class ZigHeapTopCommand : public SBCommandPluginInterface {
+public:
+    static constexpr uint64_t kDefaultCount = 10;
+
+    bool DoExecute(SBDebugger debugger, char** command, SBCommandReturnObject& result) override {
+        CommandArgs args = ParseCommandArgs(command);
+        if (args.positional.empty()) {
+            result.SetError("usage: zig heap-top <queue> [K] [--field name]");
+            return false;
+        }
+        SBFrame frame;
+        if (!GetCommandFrame(debugger, result, frame)) return false;
+
+        SBValue value = ResolveCommandValue(frame, args.positional[0]);
+        if (value.GetType().IsPointerType()) value = value.Dereference();
+        const PriorityQueueLayout& layout = g_priority_queue_layouts.Get(value.GetType(), ClassifyPriorityQueue);
+        PriorityQueueState state;
+        if (!IsZigPriorityQueue(value) || !ReadPriorityQueueState(value, layout, state)) {
+            result.SetError("error: not a std.PriorityQueue or std.PriorityDequeue");
+            return false;
+        }
+        uint64_t k = args.positional.size() > 1 ? strtoull(args.positional[1].c_str(), nullptr, 0) : kDefaultCount;
+
+        std::vector<uint8_t> items;
+        if (!ReadTargetMemory(value.GetProcess(), state.items, state.count * layout.element_size, items)) {
+            result.SetError("error: failed to read heap items");
+            return false;
+        }
+
+        // The first candidate key that strictly orders the heap is its
+        // priority; with fewer than two items any key will do
+        std::string field = args.GetString("field", "");
+        const NumericKey* key = nullptr;
+        HeapOrder order = HeapOrder::Unknown;
+        for (const NumericKey& candidate : layout.keys) {
+            if (!field.empty() && candidate.name != field) continue;
+            order = layout.dequeue ? MinMaxHeapOrder(candidate, items.data(), state.count, layout.element_size)
+                                   : BinaryHeapOrder(candidate, items.data(), state.count, layout.element_size);
+            if (order == HeapOrder::Unknown && state.count < 2) order = HeapOrder::Ascending;
+            if (order != HeapOrder::Unknown) {
+                key = &candidate;
+                break;
+            }
+        }
+        if (!key) {
+            result.SetError("error: no numeric key orders this heap; pass --field <name>");
+            return false;
+        }
+
+        result.Printf("len=%llu capacity=%llu key=%s order=%s\n", (unsigned long long)state.count,
+            (unsigned long long)state.capacity, key->name.empty() ? "(element)" : ("." + key->name).c_str(),
+            order == HeapOrder::Ascending ? "ascending" : "descending");
+        SBTarget target = value.GetTarget();
+        std::vector<uint64_t> top = HeapTopIndices(layout, *key, order, items.data(), state.count, k);
+        for (size_t rank = 0; rank < top.size(); rank++) {
+            SBValue element = MakeValueFromBytes(target, "item", items.data() + top[rank] * layout.element_size,
+                layout.element_size, layout.element_type);
+            result.Printf("#%zu items[%llu] = %s\n", rank + 1, (unsigned long long)top[rank],
+                ValueText(element).c_str());
+        }
+        result.SetStatus(eReturnStatusSuccessFinishResult);
+        return true;
     }
-    return val;
-}
+};
 
-// Type detection helpers
-bool IsZigSlice(SBValue val) {
-    if (!val.IsValid()) return false;
-    return val.GetChildMemberWithName("ptr").IsValid()
-        && val.GetChildMemberWithName("len").IsValid();
-}
+// zig tree <treap> [--from key] [--count N] [--budget N]: keys in order with
+// the depth of each node, then the tree's size and height
+class ZigTreeCommand : public SBCommandPluginInterface {
+public:
+    static constexpr uint64_t kDefaultCount = 32;
+    static constexpr uint64_t kDefaultBudget = 1000000;
 
-bool IsZigArrayList(SBValue val) {
-    if (!val.IsValid()) return false;
-    SBValue items = val.GetChildMemberWithName("items");
-    return items.IsValid() && IsZigSlice(items)
-        && val.GetChildMemberWithName("capacity").IsValid();
-}
+    bool DoExecute(SBDebugger debugger, char** command, SBCommandReturnObject& result) override {
+        CommandArgs args = ParseCommandArgs(command);
+        if (args.positional.empty()) {
+            result.SetError("usage: zig tree <treap> [--from key] [--count N] [--budget N]");
+            return false;
+        }
+        SBFrame frame;
+        if (!GetCommandFrame(debugger, result, frame)) return false;
 
-bool IsZigOptional(SBValue val) {
-    if (!val.IsValid()) return false;
-    // Zig optionals have both 'some' (discriminant) and 'data' (payload) fields
-    return val.GetChildMemberWithName("some").IsValid()
-        && val.GetChildMemberWithName("data").IsValid();
-}
+        SBValue value = ResolveCommandValue(frame, args.positional[0]);
+        if (value.GetType().IsPointerType()) value = value.Dereference();
+        const TreapLayout& layout = g_treap_layouts.Get(value.GetType(), ClassifyTreap);
+        uint8_t word[8];
+        if (!IsZigTreap(value) || !layout.valid || !ReadValueBytes(value, layout.root_offset, word, layout.word_size)) {
+            result.SetError("error: not a std.Treap");
+            return false;
+        }
+        uint64_t root = LoadUnsigned(word, layout.word_size);
+        uint64_t count = args.GetUnsigned("count", kDefaultCount);
+        uint64_t budget = args.GetUnsigned("budget", kDefaultBudget);
 
-bool IsZigErrorUnion(SBValue val) {
-    if (!val.IsValid()) return false;
-    // Zig error unions have 'tag' (error code) and 'value' (payload) fields
-    return val.GetChildMemberWithName("tag").IsValid()
-        && val.GetChildMemberWithName("value").IsValid();
-}
+        uint64_t from_key = 0;
+        const uint64_t* from = nullptr;
+        if (args.Has("from")) {
+            if (!layout.numeric || !ParseNumericKey(layout.key, args.GetString("from"), from_key)) {
+                result.SetError("error: --from needs a numeric key type and value");
+                return false;
+            }
+            from = &from_key;
+        }
 
-// Generic regex-based transformer
-using TransformFn = std::function<std::string(const std::smatch&, SBFrame)>;
+        // One extra node gives the cursor for the next page
+        SBProcess process = value.GetProcess();
+        SBTarget target = value.GetTarget();
+        std::vector<TreapNode> nodes;
+        bool more = false;
+        bool finished = WalkTreapInOrder(process, layout, root, from, count + 1, budget, nodes, more);
+        std::string cursor;
+        if (nodes.size() > count) {
+            cursor = TreapKeyText(target, layout, nodes.back());
+            nodes.pop_back();
+        }
+        for (size_t i = 0; i < nodes.size(); i++) {
+            result.Printf("[%zu] %s (depth %llu)\n", i, TreapKeyText(target, layout, nodes[i]).c_str(),
+                (unsigned long long)nodes[i].depth);
+        }
+        if (!cursor.empty()) {
+            result.Printf("next: --from %s\n", cursor.c_str());
+        } else if (!finished) {
+            result.Printf("stopped after %llu nodes (raise --budget)\n", (unsigned long long)budget);
+        }
 
-std::string ApplyRegexTransform(
-    const std::string& input,
-    const std::regex& pattern,
-    SBFrame frame,
-    TransformFn transform
-) {
-    std::string result;
-    std::string::const_iterator search_start = input.cbegin();
-    size_t last_end = 0;
+        // Height against the ideal for this size shows balance problems
+        TreapStats stats = MeasureTreap(process, layout, root, budget);
+        uint64_t ideal = 0;
+        while (ideal < 64 && (1ull << ideal) <= stats.size) ideal++;
+        result.Printf(stats.complete ? "size=%llu depth=%llu (balanced: %llu)\n"
+                                     : "size>=%llu depth>=%llu (balanced: >=%llu)\n",
+            (unsigned long long)stats.size, (unsigned long long)stats.depth, (unsigned long long)ideal);
+        result.SetStatus(eReturnStatusSuccessFinishResult);
+        return true;
+    }
+};
 
-    std::smatch match;
-    while (std::regex_search(search_start, input.cend(), match, pattern)) {
-        size_t match_start = (search_start - input.cbegin()) + match.position();
+// zig uring <ring> [--cqes] [--count N]: ring state of an
+// os.linux.IoUring; --cqes decodes the completions waiting to be reaped
+class ZigUringCommand : public SBCommandPluginInterface {
+public:
+    static constexpr uint64_t kDefaultCount = 64;
 
-        // Try transformation
-        std::string replacement = transform(match, frame);
-        if (!replacement.empty()) {
-            result += input.substr(last_end, match_start - last_end);
-            result += replacement;
-            last_end = match_start + match.length();
+    bool DoExecute(SBDebugger debugger, char** command, SBCommandReturnObject& result) override {
+        CommandArgs args = ParseCommandArgs(command, {"cqes"});
+        if (args.positional.empty()) {
+            result.SetError("usage: zig uring <ring> [--cqes] [--count N]");
+            return false;
         }
-        search_start = match.suffix().first;
+        SBFrame frame;
+        if (!GetCommandFrame(debugger, result, frame)) return false;
+
+        SBValue value = ResolveCommandValue(frame, args.positional[0]);
+        if (value.IsValid() && value.GetType().IsPointerType()) value = value.Dereference();
+        if (!value.IsValid()) {
+            result.SetError("error: no such variable");
+            return false;
+        }
+        const IoUringLayout& layout = g_io_uring_layouts.Get(value.GetType(), ClassifyIoUring);
+        IoUringState state;
+        if (!layout.valid) {
+            result.SetError("error: not a std.os.linux.IoUring");
+            return false;
+        }
+        if (!ReadIoUringState(value, layout, state)) {
+            result.SetError("error: ring memory is unreadable (not mapped in this process or core?)");
+            return false;
+        }
+        SBStream text;
+        PrintIoUringState(state, text);
+        result.Printf("%s\n", text.GetData());
+        result.Printf("sq: head=%u tail=%u sqe_head=%u sqe_tail=%u\n", state.sq_head, state.sq_tail,
+            state.sqe_head, state.sqe_tail);
+        result.Printf("cq: head=%u tail=%u mask=0x%x\n", state.cq_head, state.cq_tail, state.cq_mask);
+        if (state.SqPending() > state.sq_entries || state.CqReady() > state.cq_entries) {
+            result.Printf("warning: ring indices exceed the ring size (corrupted or uninitialized ring)\n");
+            result.SetStatus(eReturnStatusSuccessFinishResult);
+            return true;
+        }
+
+        if (args.Has("cqes")) {
+            uint64_t count = std::min<uint64_t>(state.CqReady(), args.GetUnsigned("count", kDefaultCount));
+            if (!PrintCqes(value.GetProcess(), layout, state, count, result)) return false;
+            if (count < state.CqReady()) {
+                result.Printf("... %llu more (--count)\n", (unsigned long long)(state.CqReady() - count));
+            }
+        }
+        result.SetStatus(eReturnStatusSuccessFinishResult);
+        return true;
     }
 
-    if (last_end == 0) return input;  // No transformations
-    result += input.substr(last_end);
-    return result;
-}
+private:
+    // One read covers every decoded entry: the span from head when it does
+    // not wrap, otherwise the whole array
+    static bool PrintCqes(SBProcess process, const IoUringLayout& layout, const IoUringState& state,
+                          uint64_t count, SBCommandReturnObject& result) {
+        if (count == 0) return true;
+        uint64_t first = state.cq_head & state.cq_mask;
+        bool wraps = first + count > state.cq_entries;
+        uint64_t base = wraps ? 0 : first;
+        uint64_t span = wraps ? state.cq_entries : count;
+        std::vector<uint8_t> bytes;
+        if (!ReadTargetMemory(process, state.cqes + base * layout.cqe_size, span * layout.cqe_size, bytes)) {
+            result.SetError("error: cqes array is unreadable");
+            return false;
+        }
+        for (uint64_t i = 0; i < count; i++) {
+            uint32_t index = (state.cq_head + (uint32_t)i) & state.cq_mask;
+            // io_uring_cqe { user_data: u64, res: i32, flags: u32 }
+            const uint8_t* cqe = bytes.data() + (index - base) * layout.cqe_size;
+            uint64_t user_data = LoadUnsigned(cqe, 8);
+            int32_t res = (int32_t)LoadUnsigned(cqe + 8, 4);
+            uint32_t flags = (uint32_t)LoadUnsigned(cqe + 12, 4);
+            result.Printf("[%u] user_data=0x%llx res=%d", index, (unsigned long long)user_data, res);
+            const char* err = res < 0 ? LinuxErrnoName(-res) : nullptr;
+            if (err) result.Printf(" (%s)", err);
+            if (flags) result.Printf(" flags=%s", CqeFlagsText(flags).c_str());
+            result.Printf("\n");
+        }
+        return true;
+    }
+};
 
-} // anonymous namespace
+// zig locks [--depth N]: threads blocked in std.Thread sync primitives,
+// grouped by the lock they wait on, with its decoded state and owner
+class ZigLocksCommand : public SBCommandPluginInterface {
+public:
+    static constexpr uint64_t kDefaultDepth = 32;
 
-static std::string TransformZigExpression(const std::string& expr, SBFrame frame) {
-    std::string result = expr;
+    bool DoExecute(SBDebugger debugger, char** command, SBCommandReturnObject& result) override {
+        CommandArgs args = ParseCommandArgs(command);
+        SBFrame frame;
+        if (!GetCommandFrame(debugger, result, frame)) return false;
+        SBProcess process = frame.GetThread().GetProcess();
+        uint32_t depth = (uint32_t)std::max<uint64_t>(args.GetUnsigned("depth", kDefaultDepth), 1);
 
-    // 1. Transform subscript: slice[n] -> slice.ptr[n], arraylist[n] -> arraylist.items.ptr[n]
-    static const std::regex subscript_pattern(R"(([\w.]+)\s*\[([^\]]+)\])");
-    result = ApplyRegexTransform(result, subscript_pattern, frame,
-        [](const std::smatch& m, SBFrame f) -> std::string {
-            std::string path = m[1].str();
-            std::string index = m[2].str();
-            SBValue val = GetValueAtPath(f, path);
+        // One pass over all threads; each stack is unwound only as deep as needed
+        std::vector<LockWaiter> waiters;
+        std::unordered_map<uint64_t, uint32_t> waiting_tids;   // tid -> index in waiters
+        uint32_t num_threads = process.GetNumThreads();
+        for (uint32_t i = 0; i < num_threads; i++) {
+            LockWaiter waiter;
+            if (!FindLockWait(process.GetThreadAtIndex(i), depth, waiter)) continue;
+            waiting_tids[waiter.tid] = (uint32_t)waiters.size();
+            waiters.push_back(waiter);
+        }
+        if (waiters.empty()) {
+            result.Printf("no threads waiting on locks (%u threads scanned)\n", num_threads);
+            result.SetStatus(eReturnStatusSuccessFinishResult);
+            return true;
+        }
 
-            if (IsZigSlice(val)) {
-                return path + ".ptr[" + index + "]";
+        // Group by lock address, in order of first appearance. Waiters whose
+        // frame has no `self` are listed on their own rather than as one lock
+        std::vector<uint64_t> locks;
+        std::unordered_map<uint64_t, std::vector<const LockWaiter*>> by_lock;
+        std::vector<const LockWaiter*> unknown;
+        for (const LockWaiter& w : waiters) {
+            if (w.lock_addr == 0) {
+                unknown.push_back(&w);
+                continue;
             }
-            if (IsZigArrayList(val)) {
-                return path + ".items.ptr[" + index + "]";
+            auto& group = by_lock[w.lock_addr];
+            if (group.empty()) locks.push_back(w.lock_addr);
+            group.push_back(&w);
+        }
+        for (uint64_t addr : locks) {
+            const std::vector<const LockWaiter*>& group = by_lock[addr];
+            const LockWaiter& first = *group.front();
+            uint64_t owner_tid = 0;
+            std::string state = DescribeLockState(first.lock, first.kind, owner_tid);
+            result.Printf("%s 0x%llx", kLockKindNames[(int)first.kind], (unsigned long long)addr);
+            if (!state.empty()) result.Printf(" %s", state.c_str());
+            if (owner_tid != 0) {
+                SBThread owner = process.GetThreadByID(owner_tid);
+                if (owner.IsValid()) {
+                    result.Printf(" owner=thread #%u", owner.GetIndexID());
+                } else {
+                    result.Printf(" owner=tid %llu", (unsigned long long)owner_tid);
+                }
+                auto it = waiting_tids.find(owner_tid);
+                if (it != waiting_tids.end()) {
+                    const LockWaiter& blocked = waiters[it->second];
+                    if (blocked.lock_addr != 0) {
+                        result.Printf(" (itself waiting on %s 0x%llx)", kLockKindNames[(int)blocked.kind],
+                            (unsigned long long)blocked.lock_addr);
+                    } else {
+                        result.Printf(" (itself waiting on an unknown %s)", kLockKindNames[(int)blocked.kind]);
+                    }
+                }
             }
-            return "";  // No transformation
-        });
-
-    // 2. Transform optional unwrap: optional.? -> ternary for safe null handling
-    // Note: Zig optionals have 'some' (discriminant) and 'data' (payload) fields
-    static const std::regex optional_pattern(R"(([\w.]+)\s*\.\s*\?)");
-    result = ApplyRegexTransform(result, optional_pattern, frame,
-        [](const std::smatch& m, SBFrame f) -> std::string {
-            std::string path = m[1].str();
-            SBValue val = GetValueAtPath(f, path);
-
-            if (IsZigOptional(val)) {
-                // Use ternary for runtime null check - shows data or 0 for null
-                return "(" + path + ".some ? " + path + ".data : 0)";
+            result.Printf("\n");
+            for (const LockWaiter* w : group) {
+                result.Printf("  waiting: thread #%u in %s\n", w->thread_index, w->site.c_str());
             }
-            // Check for optional pointer types (?*T) which appear as plain pointers
-            const char* type_name = val.GetTypeName();
-            if (type_name && type_name[0] == '?') {
-                // Type starts with '?' - it's an optional pointer
-                // Use ternary: non-null dereferences, null returns 0
-                return "(" + path + " ? *" + path + " : 0)";
+        }
+        if (!unknown.empty()) {
+            result.Printf("unknown lock (address not in debug info)\n");
+            for (const LockWaiter* w : unknown) {
+                result.Printf("  waiting: thread #%u on a %s in %s\n", w->thread_index,
+                    kLockKindNames[(int)w->kind], w->site.c_str());
             }
-            return "";
-        });
+        }
+        result.Printf("%zu thread%s waiting on %zu lock%s (%u threads scanned)\n", waiters.size(),
+            waiters.size() == 1 ? "" : "s", locks.size(), locks.size() == 1 ? "" : "s", num_threads);
+        result.SetStatus(eReturnStatusSuccessFinishResult);
+        return true;
+    }
+};
 
-    // 3. Transform error catch: err catch default -> (err.tag == 0 ? err.value : default)
-    static const std::regex catch_pattern(R"(([\w.]+)\s+catch\s+([\w.]+))");
-    result = ApplyRegexTransform(result, catch_pattern, frame,
-        [](const std::smatch& m, SBFrame f) -> std::string {
-            std::string path = m[1].str();
-            std::string dflt = m[2].str();
-            SBValue val = GetValueAtPath(f, path);
+// zig heap <allocator> [--top N] [--frames N] [--save name] [--diff name]:
+// live allocations of a DebugAllocator grouped by allocation stack trace
+class ZigHeapCommand : public SBCommandPluginInterface {
+public:
+    static constexpr uint64_t kDefaultTop = 10;
 
-            if (IsZigErrorUnion(val)) {
-                return "(" + path + ".tag == 0 ? " + path + ".value : " + dflt + ")";
+    bool DoExecute(SBDebugger debugger, char** command, SBCommandReturnObject& result) override {
+        CommandArgs args = ParseCommandArgs(command);
+        if (args.positional.empty()) {
+            result.SetError("usage: zig heap <allocator> [--top N] [--frames N] [--save name] [--diff name]");
+            return false;
+        }
+        SBFrame frame;
+        if (!GetCommandFrame(debugger, result, frame)) return false;
+
+        SBValue value = ResolveCommandValue(frame, args.positional[0]);
+        if (value.IsValid() && value.GetType().IsPointerType()) value = value.Dereference();
+        if (!value.IsValid()) {
+            result.SetError("error: no such variable");
+            return false;
+        }
+        SBTarget target = value.GetTarget();
+        const DebugAllocatorLayout& layout =
+            g_debug_allocator_layouts.Get(TargetType{target, value.GetType()}, ClassifyDebugAllocator);
+        if (!IsZigDebugAllocator(value) || !layout.valid) {
+            result.SetError("error: not a std.heap.DebugAllocator (or its LargeAlloc type is missing from debug info)");
+            return false;
+        }
+
+        HeapWalk walk;
+        WalkDebugAllocatorBuckets(value, layout, walk);
+        WalkDebugAllocatorLarge(value, layout, walk);
+        result.Printf("live: %llu allocations, %llu bytes (small %llu / %llu bytes in %llu buckets, large %llu / %llu bytes), %zu call sites\n",
+            (unsigned long long)(walk.small_count + walk.large_count),
+            (unsigned long long)(walk.small_bytes + walk.large_bytes),
+            (unsigned long long)walk.small_count, (unsigned long long)walk.small_bytes,
+            (unsigned long long)walk.buckets, (unsigned long long)walk.large_count,
+            (unsigned long long)walk.large_bytes, walk.sites.size());
+        if (walk.skipped_buckets > 0) {
+            result.Printf("warning: %llu buckets unreadable or of unknown layout\n",
+                (unsigned long long)walk.skipped_buckets);
+        }
+        if (layout.stack_n == 0) result.Printf("note: built without stack traces (stack_trace_frames = 0)\n");
+
+        uint64_t top = args.GetUnsigned("top", kDefaultTop);
+        uint64_t frames = args.GetUnsigned("frames", layout.stack_n);
+        std::string base = args.GetString("diff");
+        if (!base.empty()) {
+            HeapProfile before;
+            {
+                std::lock_guard<std::mutex> lock(g_heap_snapshots_mutex);
+                auto it = g_heap_snapshots.find(base);
+                if (it == g_heap_snapshots.end()) {
+                    result.SetError(("error: no snapshot named '" + base + "' (take one with --save)").c_str());
+                    return false;
+                }
+                before = it->second;
             }
-            return "";
-        });
+            PrintDiff(target, before, walk.sites, base, top, frames, result);
+        } else {
+            PrintTop(target, walk.sites, top, frames, result);
+        }
 
-    return result;
-}
+        std::string save = args.GetString("save");
+        if (!save.empty()) {
+            std::lock_guard<std::mutex> lock(g_heap_snapshots_mutex);
+            g_heap_snapshots[save] = walk.sites;
+            result.Printf("saved snapshot '%s'\n", save.c_str());
+        }
+        result.SetStatus(eReturnStatusSuccessFinishResult);
+        return true;
+    }
 
-//===----------------------------------------------------------------------===//
-// Custom Expression Command (overrides 'p')
-//===----------------------------------------------------------------------===//
+private:
+    // Each address is symbolicated once per command, however many traces share it
+    static void PrintTrace(SBTarget target, const std::vector<uint64_t>& trace, uint64_t frames,
+                           std::unordered_map<uint64_t, std::string>& symbols, SBCommandReturnObject& result) {
+        if (trace.empty()) result.Printf("    (no stack trace)\n");
+        for (size_t i = 0; i < trace.size() && i < frames; i++) {
+            auto it = symbols.find(trace[i]);
+            if (it == symbols.end()) it = symbols.emplace(trace[i], SymbolizeReturnAddress(target, trace[i])).first;
+            result.Printf("    %s\n", it->second.c_str());
+        }
+    }
 
-class ZigExpressionCommand : public SBCommandPluginInterface {
+    static void PrintTop(SBTarget target, const HeapProfile& sites, uint64_t top, uint64_t frames,
+                         SBCommandReturnObject& result) {
+        std::vector<const HeapProfile::value_type*> order;
+        for (const auto& entry : sites) order.push_back(&entry);
+        size_t shown = std::min<size_t>(top, order.size());
+        std::partial_sort(order.begin(), order.begin() + shown, order.end(),
+            [](const HeapProfile::value_type* a, const HeapProfile::value_type* b) {
+                return a->second.bytes > b->second.bytes;
+            });
+        std::unordered_map<uint64_t, std::string> symbols;
+        for (size_t i = 0; i < shown; i++) {
+            const HeapSite& site = order[i]->second;
+            result.Printf("#%zu %llu bytes in %llu allocation%s\n", i + 1, (unsigned long long)site.bytes,
+                (unsigned long long)site.count, site.count == 1 ? "" : "s");
+            PrintTrace(target, order[i]->first, frames, symbols, result);
+        }
+    }
+
+    // Call sites whose live bytes or counts changed, largest change first
+    static void PrintDiff(SBTarget target, const HeapProfile& before, const HeapProfile& after,
+                          const std::string& base, uint64_t top, uint64_t frames, SBCommandReturnObject& result) {
+        struct Delta {
+            const std::vector<uint64_t>* trace;
+            int64_t bytes;
+            int64_t count;
+            HeapSite now;
+        };
+        std::vector<Delta> deltas;
+        int64_t total_bytes = 0, total_count = 0;
+        auto add = [&](const std::vector<uint64_t>& trace, const HeapSite* was, const HeapSite* now) {
+            HeapSite zero;
+            if (!was) was = &zero;
+            if (!now) now = &zero;
+            Delta d{&trace, (int64_t)now->bytes - (int64_t)was->bytes, (int64_t)now->count - (int64_t)was->count, *now};
+            total_bytes += d.bytes;
+            total_count += d.count;
+            if (d.bytes != 0 || d.count != 0) deltas.push_back(d);
+        };
+        for (const auto& entry : after) {
+            auto it = before.find(entry.first);
+            add(entry.first, it == before.end() ? nullptr : &it->second, &entry.second);
+        }
+        for (const auto& entry : before) {
+            if (!after.count(entry.first)) add(entry.first, &entry.second, nullptr);
+        }
+        result.Printf("vs '%s': %+lld bytes, %+lld allocations, %zu call sites changed\n", base.c_str(),
+            (long long)total_bytes, (long long)total_count, deltas.size());
+        size_t shown = std::min<size_t>(top, deltas.size());
+        std::partial_sort(deltas.begin(), deltas.begin() + shown, deltas.end(), [](const Delta& a, const Delta& b) {
+            return std::llabs(a.bytes) > std::llabs(b.bytes);
+        });
+        std::unordered_map<uint64_t, std::string> symbols;
+        for (size_t i = 0; i < shown; i++) {
+            const Delta& d = deltas[i];
+            result.Printf("#%zu %+lld bytes %+lld allocations (now %llu bytes in %llu)\n", i + 1,
+                (long long)d.bytes, (long long)d.count, (unsigned long long)d.now.bytes,
+                (unsigned long long)d.now.count);
+            PrintTrace(target, *d.trace, frames, symbols, result);
+        }
+    }
+};
+
+// zig bigint <value> [--digits N] [--hex]: the full value of a
+// std.math.big.int; --digits keeps only the first and last N digits
+class ZigBigIntCommand : public SBCommandPluginInterface {
 public:
     bool DoExecute(SBDebugger debugger, char** command, SBCommandReturnObject& result) override {
-        // Reconstruct the expression from command arguments
-        std::string expr;
-        if (command) {
-            for (int i = 0; command[i] != nullptr; ++i) {
-                if (i > 0) expr += " ";
-                expr += command[i];
-            }
+        CommandArgs args = ParseCommandArgs(command, {"hex"});
+        if (args.positional.empty()) {
+            result.SetError("usage: zig bigint <value> [--digits N] [--hex]");
+            return false;
         }
+        SBFrame frame;
+        if (!GetCommandFrame(debugger, result, frame)) return false;
 
-        if (expr.empty()) {
-            result.SetError("error: no expression provided");
+        SBValue value = ResolveCommandValue(frame, args.positional[0]);
+        if (!value.IsValid()) {
+            result.SetError("error: no such variable");
+            return false;
+        }
+        if (!IsZigBigInt(value)) {
+            result.SetError("error: not a std.math.big.int Managed, Mutable or Const");
+            return false;
+        }
+        const BigIntLayout& layout = g_big_int_layouts.Get(value.GetType(), ClassifyBigInt);
+        BigIntHeader header;
+        zdb::Limbs magnitude;
+        if (!ReadBigIntHeader(value, layout, header) ||
+            !ReadBigIntLimbs(value.GetProcess(), layout, header, 0, header.len, magnitude)) {
+            result.SetError("error: failed to read limbs");
             return false;
         }
+        uint64_t bits = zdb::LimbsBitLength(magnitude);
+        const char* sign = header.negative && bits > 0 ? "-" : "";
+        std::string text = args.Has("hex") ? zdb::LimbsToHex(magnitude) : g_decimal_converter.ToDecimal(magnitude);
+        result.Printf("%s%s%s\n", sign, args.Has("hex") ? "0x" : "",
+            ElideDigits(text, args.GetUnsigned("digits", 0)).c_str());
+        result.Printf("bits=%llu limbs=%llu %s=%zu\n", (unsigned long long)bits,
+            (unsigned long long)header.len, args.Has("hex") ? "hex_digits" : "digits", text.size());
+        result.SetStatus(eReturnStatusSuccessFinishResult);
+        return true;
+    }
+};
 
-        // Get current frame
-        SBTarget target = debugger.GetSelectedTarget();
-        if (!target.IsValid()) {
-            result.SetError("error: no target");
+// zig json <value> [--depth D] [--max-bytes B]: a std.json.Value,
+// ObjectMap or Array tree as compact JSON
+class ZigJsonCommand : public SBCommandPluginInterface {
+public:
+    static constexpr uint64_t kDefaultDepth = 64;
+    static constexpr uint64_t kDefaultMaxBytes = 64 * 1024;
+
+    bool DoExecute(SBDebugger debugger, char** command, SBCommandReturnObject& result) override {
+        CommandArgs args = ParseCommandArgs(command);
+        if (args.positional.empty()) {
+            result.SetError("usage: zig json <value> [--depth D] [--max-bytes B]");
             return false;
         }
+        SBFrame frame;
+        if (!GetCommandFrame(debugger, result, frame)) return false;
 
-        SBProcess process = target.GetProcess();
-        if (!process.IsValid()) {
-            result.SetError("error: no process");
+        SBValue value = ResolveCommandValue(frame, args.positional[0]);
+        if (!value.IsValid()) {
+            result.SetError("error: no such variable");
+            return false;
+        }
+        std::string json, error;
+        if (!ZigJsonSerialize(value, args.GetUnsigned("depth", kDefaultDepth),
+                              args.GetUnsigned("max-bytes", kDefaultMaxBytes), json, error)) {
+            result.SetError(error.c_str());
             return false;
         }
+        result.Printf("%s\n", json.c_str());
+        result.SetStatus(eReturnStatusSuccessFinishResult);
+        return true;
+    }
+};
 
-        SBThread thread = process.GetSelectedThread();
-        if (!thread.IsValid()) {
-            result.SetError("error: no thread");
+// zig map-get <map> <key>: native lookup, no code runs in the inferior
+class ZigMapGetCommand : public SBCommandPluginInterface {
+public:
+    bool DoExecute(SBDebugger debugger, char** command, SBCommandReturnObject& result) override {
+        CommandArgs args = ParseCommandArgs(command);
+        if (args.positional.size() < 2) {
+            result.SetError("usage: zig map-get <map> <key>");
             return false;
         }
+        SBFrame frame;
+        if (!GetCommandFrame(debugger, result, frame)) return false;
 
-        SBFrame frame = thread.GetSelectedFrame();
-        if (!frame.IsValid()) {
-            result.SetError("error: no frame");
+        SBValue map = ResolveCommandValue(frame, args.positional[0]);
+        if (!map.IsValid()) {
+            result.SetError("error: no such variable");
             return false;
         }
+        // The command interpreter strips quotes; rejoin keys containing spaces
+        std::string key = args.positional[1];
+        for (size_t i = 2; i < args.positional.size(); i++) key += " " + args.positional[i];
 
-        // Transform Zig expressions to C
-        std::string transformed = TransformZigExpression(expr, frame);
+        HashMapLookup lookup;
+        SBType value_type;
+        std::string error;
+        if (!ZigHashMapGet(map, key, lookup, value_type, error)) {
+            result.SetError(error.c_str());
+            return false;
+        }
+        if (!lookup.found) {
+            result.Printf("null (probes=%u reads=%u)\n", lookup.probes, lookup.reads);
+        } else if (!value_type.IsValid() || value_type.GetByteSize() == 0) {
+            result.Printf("[%llu] found (probes=%u reads=%u)\n",
+                (unsigned long long)lookup.slot, lookup.probes, lookup.reads);
+        } else {
+            SBTarget target = frame.GetThread().GetProcess().GetTarget();
+            SBValue value = target.CreateValueFromAddress("value",
+                SBAddress(lookup.value_addr, target), value_type);
+            result.Printf("[%llu] %s (probes=%u reads=%u)\n", (unsigned long long)lookup.slot,
+                ValueText(value).c_str(), lookup.probes, lookup.reads);
+        }
+        result.SetStatus(eReturnStatusSuccessFinishResult);
+        return true;
+    }
+};
 
-        // Evaluate the transformed expression
-        SBExpressionOptions options;
-        options.SetTimeoutInMicroSeconds(5000000);  // 5 seconds
+// zig map-stats <map>: load factor, tombstones and probe-length distribution
+class ZigMapStatsCommand : public SBCommandPluginInterface {
+public:
+    bool DoExecute(SBDebugger debugger, char** command, SBCommandReturnObject& result) override {
+        if (!command || !command[0]) {
+            result.SetError("usage: zig map-stats <map>");
+            return false;
+        }
+        SBFrame frame;
+        if (!GetCommandFrame(debugger, result, frame)) return false;
 
-        SBValue value = frame.EvaluateExpression(transformed.c_str(), options);
+        SBValue value = ResolveCommandValue(frame, command[0]);
+        if (!value.IsValid()) {
+            result.SetError("error: no such variable");
+            return false;
+        }
+        SBValue map = ResolveHashMapUnmanaged(value);
+        const HashMapLayout& layout = g_hash_map_layouts.Get(map, ClassifyHashMap);
+        HashMapState state;
+        if (!ReadHashMapState(map, layout, state)) {
+            result.SetError("error: not a std.HashMap (or its header is unreadable)");
+            return false;
+        }
+        if (state.metadata == 0) {
+            result.Printf("size=0 (unallocated)\n");
+            result.SetStatus(eReturnStatusSuccessFinishResult);
+            return true;
+        }
 
-        if (value.GetError().Fail()) {
-            // If transformation didn't help, try original expression
-            if (transformed != expr) {
-                value = frame.EvaluateExpression(expr.c_str(), options);
-            }
-            if (value.GetError().Fail()) {
-                result.SetError(value.GetError().GetCString());
-                return false;
-            }
+        zdb::HashMapSlotStats stats;
+        if (!ScanHashMap(frame.GetThread().GetProcess(), state, stats)) {
+            result.SetError("error: failed to read metadata");
+            return false;
         }
 
-        // Format output like standard 'p' command
-        SBStream stream;
-        value.GetDescription(stream);
-        result.AppendMessage(stream.GetData());
+        double capacity = (double)state.capacity;
+        result.Printf("size=%llu capacity=%llu available=%llu max_load=%u%%\n",
+            (unsigned long long)state.size, (unsigned long long)state.capacity,
+            (unsigned long long)state.available, layout.max_load_percentage);
+        result.Printf("slots: used=%llu (%.1f%%) tombstones=%llu (%.1f%%) free=%llu (%.1f%%)\n",
+            (unsigned long long)stats.used, 100.0 * stats.used / capacity,
+            (unsigned long long)stats.tombstones, 100.0 * stats.tombstones / capacity,
+            (unsigned long long)stats.free, 100.0 * stats.free / capacity);
+        result.Printf("miss probe: mean=%.2f longest=%llu slots\n",
+            (double)stats.probe_total / capacity, (unsigned long long)stats.longest_run + 1);
+        result.Printf("occupied runs: %llu\n", (unsigned long long)stats.runs);
+        for (size_t i = 0; i < zdb::kRunHistogramBuckets; i++) {
+            if (stats.run_histogram[i] == 0) continue;
+            unsigned long long lo = 1ull << i;
+            if (i == 0) {
+                result.Printf("  len 1: %llu\n", (unsigned long long)stats.run_histogram[i]);
+            } else if (i + 1 == zdb::kRunHistogramBuckets) {
+                result.Printf("  len %llu+: %llu\n", lo, (unsigned long long)stats.run_histogram[i]);
+            } else {
+                result.Printf("  len %llu-%llu: %llu\n", lo, (lo << 1) - 1,
+                    (unsigned long long)stats.run_histogram[i]);
+            }
+        }
+        if (stats.used != state.size) {
+            result.AppendWarning("used slot count differs from size - map may be mid-update");
+        }
         result.SetStatus(eReturnStatusSuccessFinishResult);
-
         return true;
     }
 };
 
-// Global instance to prevent destruction
-static ZigExpressionCommand* g_zig_expr_cmd = nullptr;
-
 static bool IsAppleLLDB() {
     // Apple LLDB versions are 1000+ (e.g., lldb-1703.0.234.3)
     // Homebrew/upstream LLDB is < 100 (e.g., lldb version 21.1.7)
@@ -872,6 +6499,34 @@ static void RegisterZigExpressionCommand(SBDebugger debugger) {
             "Evaluate expression with Zig syntax support.");
         zig_cmd.AddCommand("p", g_zig_expr_cmd,
             "Shorthand for 'zig print'.");
+
+        // Commands live for the debugger's lifetime
+        zig_cmd.AddCommand("uring", new ZigUringCommand(),
+            "Show the ring state of a std.os.linux.IoUring and decode pending completions: zig uring <ring> [--cqes] [--count N].");
+        zig_cmd.AddCommand("locks", new ZigLocksCommand(),
+            "Group threads blocked in std.Thread sync primitives by lock, owner and waiters: zig locks [--depth N].");
+        zig_cmd.AddCommand("heap", new ZigHeapCommand(),
+            "Live DebugAllocator allocations by stack trace: zig heap <allocator> [--top N] [--frames N] [--save name] [--diff name].");
+        zig_cmd.AddCommand("bigint", new ZigBigIntCommand(),
+            "Print a std.math.big.int in full: zig bigint <value> [--digits N] [--hex].");
+        zig_cmd.AddCommand("json", new ZigJsonCommand(),
+            "Print a std.json.Value tree as compact JSON: zig json <value> [--depth D] [--max-bytes B].");
+        zig_cmd.AddCommand("tree", new ZigTreeCommand(),
+            "Walk a std.Treap in key order with node depths: zig tree <treap> [--from key] [--count N] [--budget N].");
+        zig_cmd.AddCommand("heap-top", new ZigHeapTopCommand(),
+            "List the top K entries of a std.PriorityQueue in priority order: zig heap-top <queue> [K] [--field name].");
+        zig_cmd.AddCommand("bits", new ZigBitsCommand(),
+            "Show occupancy and set bits of a std bit set: zig bits <set> [--ranges] [--count N].");
+        zig_cmd.AddCommand("walk", new ZigWalkCommand(),
+            "Follow a std linked list with a node budget and cycle detection: zig walk <list|node> [--count N] [--budget N].");
+        zig_cmd.AddCommand("column", new ZigColumnCommand(),
+            "Show one field of a std.MultiArrayList: zig column <list> .field [start[..end]].");
+        zig_cmd.AddCommand("map", new ZigMapCommand(),
+            "Page through a std.HashMap: zig map <map> [--from cursor] [--count N].");
+        zig_cmd.AddCommand("map-get", new ZigMapGetCommand(),
+            "Look up a key in a std.HashMap without running code: zig map-get <map> <key>.");
+        zig_cmd.AddCommand("map-stats", new ZigMapStatsCommand(),
+            "Show load factor, tombstones and probe lengths of a std.HashMap.");
     }
 }
 
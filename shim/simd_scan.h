@@ -0,0 +1,321 @@
+// simd_scan.h - Vectorized scans over bulk-read target memory
+//
+// Formatters read large arrays (hash map metadata, hash columns) from the
+// inferior in a few bulk reads, then classify them here 16 bytes at a time.
+// Uses GCC/Clang vector extensions, which lower to NEON on ARM64 and SSE2 on
+// x86_64 without per-architecture intrinsics.
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <algorithm>
+#include <vector>
+
+namespace zdb {
+
+typedef uint8_t ByteVec __attribute__((vector_size(16)));
+static constexpr size_t kByteVecLanes = sizeof(ByteVec);
+
+static inline ByteVec LoadByteVec(const uint8_t* p) {
+    ByteVec v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static inline ByteVec SplatByteVec(uint8_t b) {
+    ByteVec v;
+    memset(&v, b, sizeof(v));
+    return v;
+}
+
+// Comparisons yield 0xFF per matching lane
+static inline ByteVec MaskEq(ByteVec a, ByteVec b) { return (ByteVec)(a == b); }
+
+static inline bool AnyLaneSet(ByteVec v) {
+    uint64_t halves[2];
+    memcpy(halves, &v, sizeof(halves));
+    return (halves[0] | halves[1]) != 0;
+}
+
+static inline uint64_t SumLanes(ByteVec v) {
+    uint64_t sum = 0;
+    for (size_t i = 0; i < kByteVecLanes; i++) sum += v[i];
+    return sum;
+}
+
+//===----------------------------------------------------------------------===//
+// 32-bit word scans
+//===----------------------------------------------------------------------===//
+
+typedef uint32_t U32Vec __attribute__((vector_size(16)));
+static constexpr size_t kU32VecLanes = sizeof(U32Vec) / sizeof(uint32_t);
+
+// Append indices of `words` equal to `needle` (e.g. a hashes column)
+static void FindU32Matches(const uint32_t* words, size_t n, uint32_t needle, std::vector<size_t>& out) {
+    U32Vec needle_v;
+    for (size_t k = 0; k < kU32VecLanes; k++) needle_v[k] = needle;
+    size_t i = 0;
+    for (; i + kU32VecLanes <= n; i += kU32VecLanes) {
+        U32Vec v;
+        memcpy(&v, words + i, sizeof(v));
+        U32Vec eq = (U32Vec)(v == needle_v);
+        uint64_t halves[2];
+        memcpy(halves, &eq, sizeof(halves));
+        if ((halves[0] | halves[1]) == 0) continue;
+        for (size_t k = 0; k < kU32VecLanes; k++) {
+            if (eq[k]) out.push_back(i + k);
+        }
+    }
+    for (; i < n; i++) {
+        if (words[i] == needle) out.push_back(i);
+    }
+}
+
+//===----------------------------------------------------------------------===//
+// Bit sets
+//===----------------------------------------------------------------------===//
+
+// Bit sets are little-endian mask words, so bit i lives in byte i / 8 at
+// bit i % 8 whatever the mask width; these helpers work on the raw bytes.
+
+typedef uint64_t U64Vec __attribute__((vector_size(16)));
+
+// Word w of the set, with bits at or past nbits cleared
+static inline uint64_t LoadBitWord(const uint8_t* bytes, uint64_t nbits, uint64_t w) {
+    uint64_t word = 0;
+    uint64_t start = w * 64;
+    size_t avail = (size_t)std::min<uint64_t>(8, (nbits - start + 7) / 8);
+    memcpy(&word, bytes + w * 8, avail);
+    if (nbits - start < 64) word &= (1ull << (nbits - start)) - 1;
+    return word;
+}
+
+// Population count of bits [0, nbits). Two words per vector with the
+// SWAR bit-sliced count, so no popcount instruction is required.
+static uint64_t PopCountBits(const uint8_t* bytes, uint64_t nbits) {
+    const uint64_t full_words = nbits / 64;
+    uint64_t total = 0;
+    uint64_t w = 0;
+    const U64Vec m1 = {0x5555555555555555ull, 0x5555555555555555ull};
+    const U64Vec m2 = {0x3333333333333333ull, 0x3333333333333333ull};
+    const U64Vec m4 = {0x0f0f0f0f0f0f0f0full, 0x0f0f0f0f0f0f0f0full};
+    const U64Vec h01 = {0x0101010101010101ull, 0x0101010101010101ull};
+    for (; w + 2 <= full_words; w += 2) {
+        U64Vec v;
+        memcpy(&v, bytes + w * 8, sizeof(v));
+        v = v - ((v >> 1) & m1);
+        v = (v & m2) + ((v >> 2) & m2);
+        v = (v + (v >> 4)) & m4;
+        v = (v * h01) >> 56;
+        total += v[0] + v[1];
+    }
+    for (; w * 64 < nbits; w++) total += __builtin_popcountll(LoadBitWord(bytes, nbits, w));
+    return total;
+}
+
+// Append indices of set bits at or after `first`, stopping after `max`.
+// Zero words are skipped without touching their bits.
+static size_t FindSetBits(const uint8_t* bytes, uint64_t nbits, uint64_t first, size_t max,
+                          std::vector<uint64_t>& out) {
+    size_t found = 0;
+    for (uint64_t w = first / 64; w * 64 < nbits && found < max; w++) {
+        uint64_t word = LoadBitWord(bytes, nbits, w);
+        if (w == first / 64) word &= ~0ull << (first % 64);
+        while (word && found < max) {
+            out.push_back(w * 64 + __builtin_ctzll(word));
+            word &= word - 1;
+            found++;
+        }
+    }
+    return found;
+}
+
+// Half-open run of set bits
+struct BitRange {
+    uint64_t start;
+    uint64_t end;
+};
+
+// Append maximal runs of set bits, stopping after `max` runs. Returns true
+// if every run was collected. Words of all zeros or all ones cost one test.
+static bool CollectSetRanges(const uint8_t* bytes, uint64_t nbits, size_t max, std::vector<BitRange>& out) {
+    bool in_run = false;
+    uint64_t run_start = 0;
+    for (uint64_t w = 0; w * 64 < nbits; w++) {
+        uint64_t word = LoadBitWord(bytes, nbits, w);
+        uint64_t base = w * 64;
+        uint64_t width = std::min<uint64_t>(64, nbits - base);
+        uint64_t all = width == 64 ? ~0ull : (1ull << width) - 1;
+        if (word == (in_run ? all : 0)) continue;
+        uint64_t bit = 0;
+        while (bit < width) {
+            // Invert so the next transition is always the lowest set bit
+            uint64_t rest = (in_run ? ~word : word) & (all & (~0ull << bit));
+            if (rest == 0) break;
+            bit = __builtin_ctzll(rest);
+            if (in_run) {
+                out.push_back({run_start, base + bit});
+            } else {
+                if (out.size() >= max) return false;
+                run_start = base + bit;
+            }
+            in_run = !in_run;
+        }
+    }
+    if (in_run) {
+        out.push_back({run_start, nbits});
+    }
+    return true;
+}
+
+//===----------------------------------------------------------------------===//
+// std.HashMapUnmanaged metadata
+//===----------------------------------------------------------------------===//
+
+// Metadata is packed struct(u8) { fingerprint: u7, used: u1 }:
+//   free      = 0x00
+//   tombstone = 0x01
+//   used      = 0x80 | fingerprint
+static constexpr uint8_t kMetadataFree = 0x00;
+static constexpr uint8_t kMetadataTombstone = 0x01;
+static constexpr uint8_t kMetadataUsedBit = 0x80;
+
+static constexpr size_t kRunHistogramBuckets = 8;
+
+struct HashMapSlotStats {
+    uint64_t used = 0;
+    uint64_t free = 0;
+    uint64_t tombstones = 0;
+    uint64_t longest_run = 0;   // longest run of non-free slots (worst miss probe)
+    uint64_t probe_total = 0;   // slots examined by a miss starting at each slot
+    uint64_t runs = 0;
+    // Runs by length: 1, 2-3, 4-7, ..., 128+
+    uint64_t run_histogram[kRunHistogramBuckets] = {};
+};
+
+static inline void RecordRun(HashMapSlotStats& stats, uint64_t len) {
+    if (len == 0) return;
+    stats.runs++;
+    if (len > stats.longest_run) stats.longest_run = len;
+    // A miss starting k slots before the run's end examines k slots plus the free one
+    stats.probe_total += len * (len + 1) / 2;
+    size_t bucket = 0;
+    while (bucket + 1 < kRunHistogramBuckets && (2ull << bucket) <= len) bucket++;
+    stats.run_histogram[bucket]++;
+}
+
+// Classify `n` metadata bytes (n is the map capacity, a power of two).
+// Counting is vectorized; runs of occupied slots are tracked per block so
+// fully free or fully occupied blocks never fall back to byte-at-a-time.
+static HashMapSlotStats ScanHashMapMetadata(const uint8_t* meta, size_t n) {
+    HashMapSlotStats stats;
+    const ByteVec free_v = SplatByteVec(kMetadataFree);
+    const ByteVec tomb_v = SplatByteVec(kMetadataTombstone);
+    const ByteVec used_v = SplatByteVec(kMetadataUsedBit);
+
+    uint64_t leading_run = 0;   // run touching index 0, joined with the tail
+    bool seen_free = false;
+    uint64_t run = 0;
+
+    auto scalar = [&](uint8_t b) {
+        if (b == kMetadataFree) {
+            if (!seen_free) leading_run = run;
+            else RecordRun(stats, run);
+            seen_free = true;
+            run = 0;
+        } else {
+            run++;
+        }
+    };
+
+    size_t i = 0;
+    while (i + kByteVecLanes <= n) {
+        // Lane counters are 8-bit; flush before they can wrap
+        ByteVec used_acc = {}, free_acc = {}, tomb_acc = {};
+        size_t blocks = (n - i) / kByteVecLanes;
+        if (blocks > 255) blocks = 255;
+        for (size_t b = 0; b < blocks; b++, i += kByteVecLanes) {
+            ByteVec v = LoadByteVec(meta + i);
+            ByteVec is_free = MaskEq(v, free_v);
+            used_acc -= MaskEq(v & used_v, used_v);
+            free_acc -= is_free;
+            tomb_acc -= MaskEq(v, tomb_v);
+            if (!AnyLaneSet(is_free)) {
+                run += kByteVecLanes;
+            } else {
+                for (size_t k = 0; k < kByteVecLanes; k++) scalar(meta[i + k]);
+            }
+        }
+        stats.used += SumLanes(used_acc);
+        stats.free += SumLanes(free_acc);
+        stats.tombstones += SumLanes(tomb_acc);
+    }
+    for (; i < n; i++) {
+        uint8_t b = meta[i];
+        if (b & kMetadataUsedBit) stats.used++;
+        else if (b == kMetadataTombstone) stats.tombstones++;
+        else if (b == kMetadataFree) stats.free++;
+        scalar(b);
+    }
+
+    // Probing wraps, so the trailing run continues into the leading one
+    if (seen_free) {
+        RecordRun(stats, run + leading_run);
+    } else {
+        RecordRun(stats, run);
+    }
+    stats.probe_total += n;
+    return stats;
+}
+
+// Append indices (base + i) of used slots in meta[0, n), stopping after `max`.
+// Blocks without a used slot are skipped with one vector test.
+static size_t CollectUsedSlots(const uint8_t* meta, size_t n, uint64_t base, size_t max,
+                               std::vector<uint64_t>& out) {
+    const ByteVec used_v = SplatByteVec(kMetadataUsedBit);
+    size_t found = 0;
+    size_t i = 0;
+    while (found < max && i < n) {
+        if (i + kByteVecLanes <= n && !AnyLaneSet(LoadByteVec(meta + i) & used_v)) {
+            i += kByteVecLanes;
+            continue;
+        }
+        size_t end = std::min(i + kByteVecLanes, n);
+        for (; i < end && found < max; i++) {
+            if (meta[i] & kMetadataUsedBit) {
+                out.push_back(base + i);
+                found++;
+            }
+        }
+    }
+    return found;
+}
+
+// Probe step for lookups: append offsets in meta[0, n) whose byte equals
+// `tag` (0x80 | fingerprint), stopping at the first free slot. Returns true
+// if a free slot ended the probe sequence inside this range.
+static bool FindProbeCandidates(const uint8_t* meta, size_t n, uint8_t tag,
+                                std::vector<size_t>& out) {
+    const ByteVec tag_v = SplatByteVec(tag);
+    const ByteVec free_v = SplatByteVec(kMetadataFree);
+    size_t i = 0;
+    while (i < n) {
+        if (i + kByteVecLanes <= n) {
+            ByteVec v = LoadByteVec(meta + i);
+            if (!AnyLaneSet(MaskEq(v, tag_v) | MaskEq(v, free_v))) {
+                i += kByteVecLanes;
+                continue;
+            }
+        }
+        size_t end = std::min(i + kByteVecLanes, n);
+        for (; i < end; i++) {
+            if (meta[i] == kMetadataFree) return true;
+            if (meta[i] == tag) out.push_back(i);
+        }
+    }
+    return false;
+}
+
+} // namespace zdb
@@ -0,0 +1,124 @@
+// wyhash.h - Port of Zig's std.hash.Wyhash (one-shot form)
+//
+// std.StringHashMap hashes keys with Wyhash.hash(0, key) and AutoHashMap
+// hashes keys with a unique representation as Wyhash.hash(0, asBytes(&key)).
+// Reproducing the hash in-process lets zdb probe a map's metadata directly
+// instead of calling get() in the inferior.
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+namespace zdb {
+
+class Wyhash {
+public:
+    static uint64_t Hash(uint64_t seed, const uint8_t* input, size_t len) {
+        Wyhash self(seed);
+
+        if (len <= 16) {
+            self.SmallKey(input, len);
+        } else {
+            size_t i = 0;
+            if (len >= 48) {
+                while (i + 48 < len) {
+                    self.Round(input + i);
+                    i += 48;
+                }
+                self.Final0();
+            }
+            self.Final1(input, len, i);
+        }
+
+        self.m_total_len = len;
+        return self.Final2();
+    }
+
+private:
+    static constexpr uint64_t kSecret[4] = {
+        0xa0761d6478bd642full,
+        0xe7037ed1a0b428dbull,
+        0x8ebc6af09c88c6e3ull,
+        0x589965cc75374cc3ull,
+    };
+
+    uint64_t m_a = 0;
+    uint64_t m_b = 0;
+    uint64_t m_state[3];
+    uint64_t m_total_len = 0;
+
+    explicit Wyhash(uint64_t seed) {
+        m_state[0] = seed ^ Mix(seed ^ kSecret[0], kSecret[1]);
+        m_state[1] = m_state[0];
+        m_state[2] = m_state[0];
+    }
+
+    static void Mum(uint64_t& a, uint64_t& b) {
+        unsigned __int128 x = (unsigned __int128)a * b;
+        a = (uint64_t)x;
+        b = (uint64_t)(x >> 64);
+    }
+
+    static uint64_t Mix(uint64_t a, uint64_t b) {
+        Mum(a, b);
+        return a ^ b;
+    }
+
+    // Little-endian read of 4 or 8 bytes
+    static uint64_t Read(size_t bytes, const uint8_t* data) {
+        uint64_t v = 0;
+        for (size_t i = 0; i < bytes; i++) v |= (uint64_t)data[i] << (8 * i);
+        return v;
+    }
+
+    void Round(const uint8_t* input) {
+        for (size_t i = 0; i < 3; i++) {
+            uint64_t a = Read(8, input + 8 * (2 * i));
+            uint64_t b = Read(8, input + 8 * (2 * i + 1));
+            m_state[i] = Mix(a ^ kSecret[i + 1], b ^ m_state[i]);
+        }
+    }
+
+    void SmallKey(const uint8_t* input, size_t len) {
+        if (len >= 4) {
+            size_t end = len - 4;
+            size_t quarter = (len >> 3) << 2;
+            m_a = (Read(4, input) << 32) | Read(4, input + quarter);
+            m_b = (Read(4, input + end) << 32) | Read(4, input + end - quarter);
+        } else if (len > 0) {
+            m_a = ((uint64_t)input[0] << 16) | ((uint64_t)input[len >> 1] << 8) | input[len - 1];
+            m_b = 0;
+        } else {
+            m_a = 0;
+            m_b = 0;
+        }
+    }
+
+    void Final0() {
+        m_state[0] ^= m_state[1] ^ m_state[2];
+    }
+
+    // input[0, len) holds at least 16 bytes; start is where unprocessed bytes begin
+    void Final1(const uint8_t* input, size_t len, size_t start) {
+        const uint8_t* rest = input + start;
+        size_t rest_len = len - start;
+        size_t i = 0;
+        while (i + 16 < rest_len) {
+            m_state[0] = Mix(Read(8, rest + i) ^ kSecret[1], Read(8, rest + i + 8) ^ m_state[0]);
+            i += 16;
+        }
+        m_a = Read(8, input + len - 16);
+        m_b = Read(8, input + len - 8);
+    }
+
+    uint64_t Final2() {
+        m_a ^= kSecret[1];
+        m_b ^= m_state[0];
+        Mum(m_a, m_b);
+        return Mix(m_a ^ kSecret[0] ^ m_total_len, m_b ^ kSecret[1]);
+    }
+};
+
+} // namespace zdb
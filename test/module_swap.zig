@@ -0,0 +1,26 @@
+// Test program for symbol lookup across a dlclose + dlopen that keeps the
+// module count: libswap_bravo typically lands where libswap_alpha was.
+// Compile with: zig build-exe test/module_swap.zig -lc -femit-bin=test/module_swap
+// Run from the repository root, next to the libraries built by run_tests.sh.
+
+const std = @import("std");
+const builtin = @import("builtin");
+
+const Entry = *const fn () callconv(.c) u32;
+const ext = if (builtin.os.tag.isDarwin()) ".dylib" else ".so";
+
+pub fn main() !void {
+    var alpha_lib = try std.DynLib.open("test/libswap_alpha" ++ ext);
+    const alpha: Entry = alpha_lib.lookup(Entry, "swapAlpha") orelse return error.MissingSymbol;
+    std.mem.doNotOptimizeAway(alpha());
+    std.debug.print("Swap stop: alpha loaded\n", .{});
+    std.mem.doNotOptimizeAway(&alpha);
+    alpha_lib.close();
+
+    var bravo_lib = try std.DynLib.open("test/libswap_bravo" ++ ext);
+    defer bravo_lib.close();
+    const bravo: Entry = bravo_lib.lookup(Entry, "swapBravo") orelse return error.MissingSymbol;
+    std.mem.doNotOptimizeAway(bravo());
+    std.debug.print("Swap stop: bravo loaded\n", .{});
+    std.mem.doNotOptimizeAway(&bravo);
+}
@@ -44,6 +44,13 @@ zig build
 echo "Building test program..."
 (cd test && zig build-exe test_types.zig -femit-bin=test_types -fno-strip 2>/dev/null)
 
+# Two same-shaped libraries swapped by dlclose + dlopen, and their loader
+LIB_EXT=so
+[ "$(uname)" = "Darwin" ] && LIB_EXT=dylib
+(cd test && zig build-lib -dynamic swap_alpha.zig -femit-bin=libswap_alpha.$LIB_EXT -fno-strip 2>/dev/null)
+(cd test && zig build-lib -dynamic swap_bravo.zig -femit-bin=libswap_bravo.$LIB_EXT -fno-strip 2>/dev/null)
+(cd test && zig build-exe module_swap.zig -lc -femit-bin=module_swap -fno-strip 2>/dev/null)
+
 # Find offset file
 OFFSET_FILE="${ZDB_OFFSETS_FILE:-$HOME/.config/zdb/offsets/lldb-21.1.7.json}"
 if [ ! -f "$OFFSET_FILE" ]; then
@@ -62,7 +69,7 @@ echo "Running formatter tests with $LLDB..."
 # Capture LLDB output - test formatters and expression syntax
 OUTPUT=$("$LLDB" test/test_types \
     -o "plugin load zig-out/lib/libzdb.dylib" \
-    -o "b test_types.zig:157" \
+    -o "breakpoint set --file test_types.zig --source-pattern-regexp 'Breakpoint here'" \
     -o "run" \
     -o "frame variable" \
     -o "p int_slice[0]" \
@@ -70,6 +77,28 @@ OUTPUT=$("$LLDB" test/test_types \
     -o "p list[0]" \
     -o "p test_struct.optional_value.?" \
     -o "p test_struct.error_result catch 0" \
+    -o "p map.get(\"two\")" \
+    -o "p wide_map.get(0x123456789a)" \
+    -o "p amap.get(\"beta\")" \
+    -o "p wide_amap.get(0xabcdef)" \
+    -o "zig map map" \
+    -o "zig map map --count 2" \
+    -o "zig map-get map three" \
+    -o "zig map-stats map" \
+    -o "p points.items(.y)[1]" \
+    -o "zig column points .x" \
+    -o "p seglist[6]" \
+    -o "zig walk tasks" \
+    -o "zig bits free_slots --ranges" \
+    -o "zig heap-top pq 3" \
+    -o "zig heap-top jobs 1" \
+    -o "zig tree treap --from 15 --count 2" \
+    -o "zig json json_value --depth 1" \
+    -o "zig bigint big --digits 4" \
+    -o "zig heap gpa --top 1 --save start" \
+    -o "zig heap gpa --diff start" \
+    -o "zig locks" \
+    -o "p aw.writer" \
     -o "quit" 2>&1)
 
 FAILED=0
@@ -77,7 +106,8 @@ FAILED=0
 check() {
     local name="$1"
     local pattern="$2"
-    if echo "$OUTPUT" | grep -qE "$pattern"; then
+    local output="${3:-$OUTPUT}"
+    if echo "$output" | grep -qE "$pattern"; then
         echo "✓ $name"
     else
         echo "✗ $name - expected: $pattern"
@@ -95,15 +125,86 @@ check "Byte slice" 'byte_slice = "abcde"'
 # Test slice formatter
 check "Int slice" 'int_slice = len=5 ptr='
 
+# Test function pointer symbol lookup
+check "Function pointer" 'fn_ptr = 0x[0-9a-f]+ test_types\.lessThan'
+
+# Test vector formatter (one read, lanes decoded by element type)
+check "Vector int" 'int_vec = <1, -2, 3, 4>'
+check "Vector float" 'float_vec = <1\.5, -0\.25>'
+check "Vector bool" 'bool_vec = <true, false, true, true> mask=0b1101 set=3'
+
+# Test optional formatter (flag, pointer, slice and error set encodings)
+check "Optional some" 'some_value = 42'
+check "Optional null" 'none_value = null'
+check "Optional null pointer" 'none_pointer = null'
+check "Optional slice" 'some_slice = "maybe"'
+check "Optional null slice" 'none_slice = null'
+check "Optional error set" 'some_error = error\.NetworkError'
+check "Optional null error set" 'none_error = null'
+
 # Test enum formatter (shows "blue .blue" - native enum value + our .prefix)
 check "Enum" 'color = blue \.blue'
+check "EnumArray" 'color_counts = \.\{ \.red = 0, \.green = 0, \.blue = 3, \.yellow = 0 \}'
+check "EnumMap" 'color_map = \.\{ \.red = 1, \.blue = 3 \}'
+check "EnumSet" 'color_set = \.\{ \.green \}'
 
 # Test struct formatter (test_struct has 5 fields)
 check "Struct" 'test_struct = \{ 5 fields \}'
 
+# Test packed struct formatter (fields decoded from the backing integer)
+check "Packed struct" 'header = \.\{ \.flags = 0b101, \.kind = \.write, \.len = 12 \}'
+
 # Test std library types
 check "ArrayList" 'list = len=3'
 check "HashMap" 'map = size=3'
+check "HashMap load" 'map = size=3 capacity=[0-9]+ load=[0-9.]+% tombstones=0'
+# Slots are Wyhash(key) & 7 at capacity 8: "one" 3, "three" 4, "two" 6
+check "Map entries" '^\[3\] "one" = 1'
+check "Map entries order" '^\[6\] "two" = 2'
+check "Map page" '^\[4\] "three" = 3$'
+check "Map cursor" '^next: --from 5$'
+check "Expr: map.get" 'map.get\("two"\) = 2'
+check "Expr: padded key get" 'wide_map.get\(0x123456789a\) = 5'
+# "three" hashes to its own slot, 4: one metadata read, then the slice and its bytes
+check "Map get" '^\[4\] 3 \(probes=1 reads=3\)$'
+check "ArrayHashMap" 'amap = size=3 \{ "alpha" = 1, "beta" = 2, "gamma" = 3 \}'
+check "Expr: arraymap.get" 'amap.get\("beta"\) = 2'
+check "Expr: padded arraymap get" 'wide_amap.get\(0xabcdef\) = 9'
+check "Map stats" 'slots: used=3 .* tombstones=0'
+# Slots 3-4 and 6 used: (3 + 1 + 8 free/run probes) / 8
+check "Map probes" '^miss probe: mean=1\.50 longest=3 slots$'
+check "MultiArrayList" 'points = len=3 capacity=[0-9]+ fields=\.x,\.y'
+check "Expr: items(.field)[i]" 'points.items\(\.y\)\[1\] = 20'
+check "Column" '\[2\] 3'
+check "SegmentedList" 'seglist = len=7 \[1, 2, 3, 4, \.\.\.\]'
+check "Expr: seglist[n]" 'seglist\[6\] = 7'
+check "LinkedList" 'tasks = len=3'
+check "Walk" 'end \(len=3\)'
+check "BitSet" 'small_bits = bits=16 set=2 \{3, 9\}'
+check "DynamicBitSet" 'free_slots = bits=100 set=6 \{1, 2, 3, 4, 64, 99\}'
+check "Bit ranges" 'ranges: 1-4, 64, 99'
+check "PriorityQueue" 'pq = len=5 capacity=[0-9]+ top=1'
+check "Heap top" '#3 items\[[0-9]+\] = 5'
+check "Heap top key" 'key=\.deadline order=ascending'
+check "Treap" 'treap = size=5 depth=[0-9]+ \{0, 10, 20, 30, \.\.\.\}'
+check "Tree walk" 'next: --from 40'
+check "JSON" 'json_value = \{"name":"zdb","tags":\["a","b"\],"n":3\}'
+check "JSON depth cut" '^\{"name":"zdb","tags":\[\.\.\.\],"n":3\}'
+check "JSON depth" '^\{"name":"zdb","tags":\[.{1,3}\],"n":3\}'
+check "BigInt" 'big = -12345678901234567890123 \(-0x29d42b64e76714244cb, 74 bits\)'
+check "BigInt digits" '^-1234\.\.\.\(23 digits\)\.\.\.0123'
+check "ArenaAllocator" 'arena = used=100 reserved=[0-9]+ buffers=1'
+check "Allocator impl" 'arena_allocator = heap\.arena_allocator\.ArenaAllocator@0x[0-9a-f]+ used=100'
+check "FixedBufferAllocator" 'fba = used=120 capacity=1024 \(11\.7%\)'
+check "MemoryPool" 'pool = free=2 used=[0-9]+ reserved=[0-9]+ buffers=1'
+check "Thread.Pool" 'thread_pool = threads=2 queued=[0-9]+'
+check "WaitGroup" 'wait_group = pending=2'
+check "Heap walk" 'live: [1-9][0-9]* allocations, [0-9]+ bytes .*call sites'
+check "Heap top site" '#1 [0-9]+ bytes in [0-9]+ allocation'
+check "Heap diff" "vs 'start': \+0 bytes, \+0 allocations, 0 call sites changed"
+check "Io.Reader" 'io_reader = buffered=15/16 \(93\.8%\) seek=1 end=16 "ET / HTTP/1\.1\\r\\n"'
+check "Io.Writer impl" 'buffered=6/[0-9]+ .*"hello\\n" impl=Io\.Writer\.Allocating'
+check "Locks" 'waiting: thread #[0-9]+ in Thread\.Pool\.worker'
 
 # Test Zig expression syntax (transparent via 'p' command)
 check "Expr: slice[n]" '\(int\).*= 1'
@@ -112,6 +213,18 @@ check "Expr: arraylist[n]" '\(int\).*= 10'
 check "Expr: optional.?" '\(int\).*= 42'
 check "Expr: err catch" '\(int\).*= 100'
 
+# Symbol lookup after a dlclose + dlopen that keeps the module count
+SWAP_OUTPUT=$("$LLDB" test/module_swap \
+    -o "plugin load zig-out/lib/libzdb.dylib" \
+    -o "breakpoint set --file module_swap.zig --source-pattern-regexp 'Swap stop'" \
+    -o "run" \
+    -o "frame variable alpha" \
+    -o "continue" \
+    -o "frame variable bravo" \
+    -o "quit" 2>&1)
+check "Module swap: before" 'alpha = 0x[0-9a-f]+ swapAlpha' "$SWAP_OUTPUT"
+check "Module swap: after" 'bravo = 0x[0-9a-f]+ swapBravo' "$SWAP_OUTPUT"
+
 echo ""
 if [ $FAILED -eq 0 ]; then
     echo "All tests passed!"
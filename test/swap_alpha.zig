@@ -0,0 +1,6 @@
+// Shared library loaded and then unloaded by module_swap.zig
+// Compile with: zig build-lib -dynamic test/swap_alpha.zig -femit-bin=test/libswap_alpha.<so|dylib>
+
+export fn swapAlpha() callconv(.c) u32 {
+    return 0xa1;
+}
@@ -0,0 +1,6 @@
+// Shared library loaded in swap_alpha's place by module_swap.zig
+// Compile with: zig build-lib -dynamic test/swap_bravo.zig -femit-bin=test/libswap_bravo.<so|dylib>
+
+export fn swapBravo() callconv(.c) u32 {
+    return 0xb2;
+}
@@ -25,6 +25,25 @@ const Point = struct {
     y: i32,
 };
 
+// Intrusive linked list element
+const Task = struct {
+    id: i32,
+    node: std.SinglyLinkedList.Node = .{},
+};
+
+fn lessThan(_: void, a: i32, b: i32) std.math.Order {
+    return std.math.order(a, b);
+}
+
+const Job = struct {
+    queue: u8, // same for every job, so it orders nothing
+    deadline: u32,
+};
+
+fn earlierDeadline(_: void, a: Job, b: Job) std.math.Order {
+    return std.math.order(a.deadline, b.deadline);
+}
+
 // Larger struct for testing
 const Person = struct {
     name: []const u8,
@@ -34,6 +53,13 @@ const Person = struct {
     location: Point,
 };
 
+// Packed struct for testing (bit-field decode)
+const Header = packed struct {
+    flags: u3,
+    kind: enum(u2) { read, write, close },
+    len: u11,
+};
+
 // Enum for testing
 const Color = enum {
     red,
@@ -69,6 +95,10 @@ pub fn main() !void {
     const none_value: ?i32 = null;
     const some_pointer: ?*const i32 = &int_slice[0];
     const none_pointer: ?*const i32 = null;
+    const some_slice: ?[]const u8 = "maybe";
+    const none_slice: ?[]const u8 = null;
+    const some_error: ?MyError = MyError.NetworkError;
+    const none_error: ?MyError = null;
 
     // Test error unions
     const success_result: MyError!i32 = 100;
@@ -96,6 +126,15 @@ pub fn main() !void {
     // Test enums
     const color: Color = .blue;
 
+    // Test enum-indexed containers
+    var color_counts = std.EnumArray(Color, i32).initFill(0);
+    color_counts.set(.blue, 3);
+    var color_map: std.EnumMap(Color, i32) = .{};
+    color_map.put(.red, 1);
+    color_map.put(.blue, 3);
+    var color_set = std.EnumSet(Color).initEmpty();
+    color_set.insert(.green);
+
     // Test pointers
     const ptr_to_int: *const i32 = &fixed_array[2];
     const many_ptr: [*]const i32 = &fixed_array;
@@ -117,6 +156,124 @@ pub fn main() !void {
     try map.put(allocator, "two", 2);
     try map.put(allocator, "three", 3);
 
+    // Padded integer keys hash only their 6 significant bytes
+    var wide_map: std.AutoHashMapUnmanaged(u48, i32) = .empty;
+    defer wide_map.deinit(allocator);
+    try wide_map.put(allocator, 0x123456789a, 5);
+
+    // Test ArrayHashMap (insertion-ordered)
+    var amap: std.StringArrayHashMapUnmanaged(i32) = .empty;
+    defer amap.deinit(allocator);
+    try amap.put(allocator, "alpha", 1);
+    try amap.put(allocator, "beta", 2);
+    try amap.put(allocator, "gamma", 3);
+
+    var wide_amap: std.AutoArrayHashMapUnmanaged(u24, i32) = .empty;
+    defer wide_amap.deinit(allocator);
+    try wide_amap.put(allocator, 0xabcdef, 9);
+
+    // Test MultiArrayList (struct-of-arrays)
+    var points: std.MultiArrayList(Point) = .empty;
+    defer points.deinit(allocator);
+    try points.append(allocator, .{ .x = 1, .y = 10 });
+    try points.append(allocator, .{ .x = 2, .y = 20 });
+    try points.append(allocator, .{ .x = 3, .y = 30 });
+
+    // Test SegmentedList (prealloc segment plus two dynamic shelves)
+    var seglist: std.SegmentedList(i32, 2) = .{};
+    defer seglist.deinit(allocator);
+    for (1..8) |i| try seglist.append(allocator, @intCast(i));
+
+    // Test SinglyLinkedList (intrusive, Zig 0.15 API)
+    var task_a: Task = .{ .id = 1 };
+    var task_b: Task = .{ .id = 2 };
+    var task_c: Task = .{ .id = 3 };
+    var tasks: std.SinglyLinkedList = .{};
+    tasks.prepend(&task_c.node);
+    tasks.prepend(&task_b.node);
+    tasks.prepend(&task_a.node);
+
+    // Test bit sets (inline and heap-allocated masks)
+    var small_bits = std.StaticBitSet(16).initEmpty();
+    small_bits.set(3);
+    small_bits.set(9);
+    var free_slots = try std.DynamicBitSetUnmanaged.initEmpty(allocator, 100);
+    defer free_slots.deinit(allocator);
+    free_slots.setRangeValue(.{ .start = 1, .end = 5 }, true);
+    free_slots.set(64);
+    free_slots.set(99);
+
+    // Test PriorityQueue (min-heap)
+    var pq = std.PriorityQueue(i32, void, lessThan).init(allocator, {});
+    defer pq.deinit();
+    for ([_]i32{ 5, 1, 8, 3, 9 }) |v| try pq.add(v);
+
+    var jobs = std.PriorityQueue(Job, void, earlierDeadline).init(allocator, {});
+    defer jobs.deinit();
+    for ([_]u32{ 40, 10, 30, 20 }) |d| try jobs.add(.{ .queue = 1, .deadline = d });
+
+    // Test Treap (caller-owned nodes)
+    const IdTreap = std.Treap(u64, std.math.order);
+    var treap: IdTreap = .{};
+    var treap_nodes: [5]IdTreap.Node = undefined;
+    for (&treap_nodes, 0..) |*node, i| {
+        var entry = treap.getEntryFor(@as(u64, i) * 10);
+        entry.set(node);
+    }
+
+    // Test std.json.Value tree
+    const parsed = try std.json.parseFromSlice(std.json.Value, allocator,
+        \\{"name":"zdb","tags":["a","b"],"n":3}
+    , .{});
+    defer parsed.deinit();
+    const json_value = parsed.value;
+
+    // Test arbitrary-precision integer
+    var big = try std.math.big.int.Managed.initSet(allocator, -12345678901234567890123);
+    defer big.deinit();
+
+    // Test allocator state
+    var arena = std.heap.ArenaAllocator.init(allocator);
+    defer arena.deinit();
+    _ = try arena.allocator().alloc(u8, 100);
+    const arena_allocator = arena.allocator();
+    var fba_buffer: [1024]u8 = undefined;
+    var fba = std.heap.FixedBufferAllocator.init(&fba_buffer);
+    _ = try fba.allocator().alloc(u8, 120);
+    var pool = std.heap.MemoryPool(u64).init(allocator);
+    defer pool.deinit();
+    const pooled_a = try pool.create();
+    const pooled_b = try pool.create();
+    _ = try pool.create();
+    pool.destroy(pooled_a);
+    pool.destroy(pooled_b);
+
+    // Test thread pool and wait group
+    var thread_pool: std.Thread.Pool = undefined;
+    try thread_pool.init(.{ .allocator = allocator, .n_jobs = 2 });
+    defer thread_pool.deinit();
+    var wait_group: std.Thread.WaitGroup = .{};
+    wait_group.start();
+    wait_group.start();
+
+    // Test std.Io buffered interfaces
+    var io_reader: std.Io.Reader = .fixed("GET / HTTP/1.1\r\n");
+    _ = try io_reader.takeByte();
+    var aw: std.Io.Writer.Allocating = .init(allocator);
+    defer aw.deinit();
+    try aw.writer.writeAll("hello\n");
+
+    // Test function pointer
+    const fn_ptr: *const fn (void, i32, i32) std.math.Order = &lessThan;
+
+    // Test SIMD vectors
+    const int_vec: @Vector(4, i32) = .{ 1, -2, 3, 4 };
+    const float_vec: @Vector(2, f32) = .{ 1.5, -0.25 };
+    const bool_vec: @Vector(4, bool) = .{ true, false, true, true };
+
+    // Test packed struct
+    const header: Header = .{ .flags = 0b101, .kind = .write, .len = 12 };
+
     // Test C string (sentinel-terminated)
     const c_string: [*:0]const u8 = "C string test";
 
@@ -135,6 +292,10 @@ pub fn main() !void {
     std.mem.doNotOptimizeAway(&none_value);
     std.mem.doNotOptimizeAway(&some_pointer);
     std.mem.doNotOptimizeAway(&none_pointer);
+    std.mem.doNotOptimizeAway(&some_slice);
+    std.mem.doNotOptimizeAway(&none_slice);
+    std.mem.doNotOptimizeAway(&some_error);
+    std.mem.doNotOptimizeAway(&none_error);
     std.mem.doNotOptimizeAway(&success_result);
     std.mem.doNotOptimizeAway(&error_result);
     std.mem.doNotOptimizeAway(&circle);
@@ -145,11 +306,40 @@ pub fn main() !void {
     std.mem.doNotOptimizeAway(&point);
     std.mem.doNotOptimizeAway(&person);
     std.mem.doNotOptimizeAway(&color);
+    std.mem.doNotOptimizeAway(&color_counts);
+    std.mem.doNotOptimizeAway(&color_map);
+    std.mem.doNotOptimizeAway(&color_set);
     std.mem.doNotOptimizeAway(&ptr_to_int);
     std.mem.doNotOptimizeAway(&many_ptr);
     std.mem.doNotOptimizeAway(&tuple);
     std.mem.doNotOptimizeAway(&list);
     std.mem.doNotOptimizeAway(&map);
+    std.mem.doNotOptimizeAway(&wide_map);
+    std.mem.doNotOptimizeAway(&amap);
+    std.mem.doNotOptimizeAway(&wide_amap);
+    std.mem.doNotOptimizeAway(&points);
+    std.mem.doNotOptimizeAway(&seglist);
+    std.mem.doNotOptimizeAway(&tasks);
+    std.mem.doNotOptimizeAway(&small_bits);
+    std.mem.doNotOptimizeAway(&free_slots);
+    std.mem.doNotOptimizeAway(&pq);
+    std.mem.doNotOptimizeAway(&jobs);
+    std.mem.doNotOptimizeAway(&treap);
+    std.mem.doNotOptimizeAway(&json_value);
+    std.mem.doNotOptimizeAway(&big);
+    std.mem.doNotOptimizeAway(&arena);
+    std.mem.doNotOptimizeAway(&arena_allocator);
+    std.mem.doNotOptimizeAway(&fba);
+    std.mem.doNotOptimizeAway(&pool);
+    std.mem.doNotOptimizeAway(&thread_pool);
+    std.mem.doNotOptimizeAway(&wait_group);
+    std.mem.doNotOptimizeAway(&io_reader);
+    std.mem.doNotOptimizeAway(&aw);
+    std.mem.doNotOptimizeAway(&fn_ptr);
+    std.mem.doNotOptimizeAway(&int_vec);
+    std.mem.doNotOptimizeAway(&float_vec);
+    std.mem.doNotOptimizeAway(&bool_vec);
+    std.mem.doNotOptimizeAway(&header);
     std.mem.doNotOptimizeAway(&test_struct);
     std.mem.doNotOptimizeAway(&c_string);
 